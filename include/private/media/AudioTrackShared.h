@@ -234,6 +234,8 @@ struct audio_track_cblk_t
     volatile    int32_t     mFutex;     // event flag: down (P) by client,
                                         // up (V) by server or binderDied() or interrupt()
 #define CBLK_FUTEX_WAKE 1               // if event flag bit is set, then a deferred wake is pending
+#define CBLK_FUTEX_WAITER 2             // set by client while it is in (or entering) FUTEX_WAIT,
+                                        // server skips FUTEX_WAKE syscalls when it is clear
 
 private:
 
@@ -382,6 +384,19 @@ public:
     // Call to force an obtainBuffer() to return quickly with -EINTR
     void        interrupt();
 
+    // For low latency tracks: when obtainBuffer() would block, first spin briefly waiting
+    // for the server, which then needs no FUTEX_WAKE, and we no FUTEX_WAIT.
+    // The spin duration adapts to how often spinning is successful.
+    void        setSpinBeforeWait(bool enabled) {
+        mSpinNs = enabled ? kInitialSpinNs : 0;
+    }
+
+    // Number of times obtainBuffer() spun, and how many of those the server released in time.
+    void        getSpinStats(uint32_t* spins, uint32_t* woken) const {
+        *spins = mSpins;
+        *woken = mSpinsWoken;
+    }
+
     Modulo<uint32_t> getPosition() {
         return mEpoch + mCblk->mServer;
     }
@@ -427,9 +442,21 @@ public:
     virtual void stop() { }; // called by client in AudioTrack::stop()
 
 private:
+    // Spins until the server sets CBLK_FUTEX_WAKE or mSpinNs elapse, and adapts mSpinNs.
+    // Returns true if the flag was set.
+    bool        spinForWake();
+
+    static constexpr int32_t kInitialSpinNs = 10000;
+    static constexpr int32_t kMinSpinNs = 1000;
+    static constexpr int32_t kMaxSpinNs = 50000;
+
     // This is a copy of mCblk->mBufferSizeInFrames
     uint32_t   mBufferSizeInFrames;  // effective size of the buffer
 
+    int32_t    mSpinNs;     // spin duration before a futex wait, or 0 to not spin
+    uint32_t   mSpins;      // see getSpinStats()
+    uint32_t   mSpinsWoken;
+
     Modulo<uint32_t> mEpoch;
 
     // The shared buffer contents referred to by the timestamp observer
@@ -18,6 +18,8 @@
 //#define LOG_NDEBUG 0
 #include <utils/Log.h>
 
+#include <algorithm>
+
 #include "AAudioFlowGraph.h"
 
 #include <flowgraph/Limiter.h>
@@ -37,6 +39,8 @@
 #include <flowgraph/SourceI32.h>
 #include <flowgraph/SourceI8_24.h>
 
+#include <audio_utils/primitives.h>
+
 using namespace FLOWGRAPH_OUTER_NAMESPACE::flowgraph;
 
 aaudio_result_t AAudioFlowGraph::configure(audio_format_t sourceFormat,
@@ -48,7 +52,8 @@ aaudio_result_t AAudioFlowGraph::configure(audio_format_t sourceFormat,
                           bool useMonoBlend,
                           bool useVolumeRamps,
                           float audioBalance,
-                          aaudio::resampler::MultiChannelResampler::Quality resamplerQuality) {
+                          aaudio::resampler::MultiChannelResampler::Quality resamplerQuality,
+                          bool allowFusedChain) {
     FlowGraphPortFloatOutput *lastOutput = nullptr;
 
     ALOGD("%s() source format = 0x%08x, channels = %d, sample rate = %d, "
@@ -153,15 +158,163 @@ aaudio_result_t AAudioFlowGraph::configure(audio_format_t sourceFormat,
     }
     lastOutput->connect(&mSink->input);
 
+    // Without sample rate conversion or mono blend, each source frame produces exactly one
+    // sink frame, so the chain can be run as a single pass over large blocks.
+    // The nodes are still connected and hold the state of the limiter and the ramps.
+    mSourceFormat = sourceFormat;
+    mSinkFormat = sinkFormat;
+    mSourceChannelCount = sourceChannelCount;
+    mSinkChannelCount = sinkChannelCount;
+    mFused = allowFusedChain && mRateConverter == nullptr && mMonoBlend == nullptr;
+    if (mFused) {
+        mFusedBuffer = std::make_unique<float[]>(kFusedBlockFrames * sinkChannelCount);
+    }
+    ALOGD("%s() fused = %d", __func__, mFused);
+
     return AAUDIO_OK;
 }
 
+static void convertToFloat(audio_format_t format, const uint8_t *source, float *destination,
+                           int32_t numSamples) {
+    switch (format) {
+        case AUDIO_FORMAT_PCM_FLOAT:
+            memcpy(destination, source, numSamples * sizeof(float));
+            break;
+        case AUDIO_FORMAT_PCM_16_BIT:
+            memcpy_to_float_from_i16(destination, (const int16_t *) source, numSamples);
+            break;
+        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+            memcpy_to_float_from_p24(destination, source, numSamples);
+            break;
+        case AUDIO_FORMAT_PCM_32_BIT:
+            memcpy_to_float_from_i32(destination, (const int32_t *) source, numSamples);
+            break;
+        case AUDIO_FORMAT_PCM_8_24_BIT:
+            memcpy_to_float_from_q8_23(destination, (const int32_t *) source, numSamples);
+            break;
+        default: // rejected by configure()
+            break;
+    }
+}
+
+// The integer conversions clip to the range of the sink format.
+static void convertFromFloat(audio_format_t format, const float *source, uint8_t *destination,
+                             int32_t numSamples) {
+    switch (format) {
+        case AUDIO_FORMAT_PCM_FLOAT:
+            memcpy(destination, source, numSamples * sizeof(float));
+            break;
+        case AUDIO_FORMAT_PCM_16_BIT:
+            memcpy_to_i16_from_float((int16_t *) destination, source, numSamples);
+            break;
+        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+            memcpy_to_p24_from_float(destination, source, numSamples);
+            break;
+        case AUDIO_FORMAT_PCM_32_BIT:
+            memcpy_to_i32_from_float((int32_t *) destination, source, numSamples);
+            break;
+        case AUDIO_FORMAT_PCM_8_24_BIT:
+            memcpy_to_q8_23_from_float_with_clamp((int32_t *) destination, source, numSamples);
+            break;
+        default: // rejected by configure()
+            break;
+    }
+}
+
+// Expand mono to channelCount channels in place.
+// Work backwards so that no input sample is overwritten before it is read.
+static void expandMonoInPlace(float *buffer, int32_t numFrames, int32_t channelCount) {
+    for (int32_t frame = numFrames - 1; frame >= 0; frame--) {
+        const float sample = buffer[frame];
+        float *output = &buffer[frame * channelCount];
+        for (int32_t ch = 0; ch < channelCount; ch++) {
+            output[ch] = sample;
+        }
+    }
+}
+
+void AAudioFlowGraph::applyVolumeRampsFused(float *buffer, int32_t numFrames) {
+    const int32_t channelCount = mSinkChannelCount;
+    bool ramping = false;
+    for (auto& ramp : mVolumeRamps) {
+        ramp->updateRamp();
+        ramping |= ramp->isRamping();
+    }
+    if (ramping) { // This doesn't happen very often.
+        for (int32_t ch = 0; ch < channelCount; ch++) {
+            mVolumeRamps[ch]->applyInterleaved(&buffer[ch], numFrames, channelCount);
+        }
+        return;
+    }
+
+    // Constant gains. Keep the loops simple so that the compiler can vectorize them.
+    if (channelCount == 2) {
+        const float left = mVolumeRamps[0]->getLevel();
+        const float right = mVolumeRamps[1]->getLevel();
+        for (int32_t i = 0; i < numFrames; i++) {
+            buffer[2 * i] *= left;
+            buffer[2 * i + 1] *= right;
+        }
+    } else if (channelCount == 1) {
+        const float level = mVolumeRamps[0]->getLevel();
+        for (int32_t i = 0; i < numFrames; i++) {
+            buffer[i] *= level;
+        }
+    } else {
+        for (int32_t i = 0; i < numFrames; i++) {
+            for (int32_t ch = 0; ch < channelCount; ch++) {
+                *buffer++ *= mVolumeRamps[ch]->getLevel();
+            }
+        }
+    }
+}
+
+int32_t AAudioFlowGraph::readFused(void *destination, int32_t numFrames) {
+    const size_t sourceBytesPerFrame = audio_bytes_per_frame(mSourceChannelCount, mSourceFormat);
+    const size_t sinkBytesPerFrame = audio_bytes_per_frame(mSinkChannelCount, mSinkFormat);
+    uint8_t *output = static_cast<uint8_t *>(destination);
+    float *buffer = mFusedBuffer.get();
+
+    const int32_t framesToRead = std::min(numFrames, mFusedSourceFramesLeft);
+    int32_t framesLeft = framesToRead;
+    while (framesLeft > 0) {
+        const int32_t numBlockFrames = std::min(framesLeft, kFusedBlockFrames);
+        const int32_t numSourceSamples = numBlockFrames * mSourceChannelCount;
+
+        convertToFloat(mSourceFormat, mFusedSourceData, buffer, numSourceSamples);
+        if (mLimiter != nullptr) {
+            mLimiter->processSamples(buffer, buffer, numSourceSamples);
+        }
+        if (mChannelConverter != nullptr) {
+            expandMonoInPlace(buffer, numBlockFrames, mSinkChannelCount);
+        }
+        if (!mVolumeRamps.empty()) {
+            applyVolumeRampsFused(buffer, numBlockFrames);
+        }
+        convertFromFloat(mSinkFormat, buffer, output, numBlockFrames * mSinkChannelCount);
+
+        mFusedSourceData += numBlockFrames * sourceBytesPerFrame;
+        mFusedSourceFramesLeft -= numBlockFrames;
+        output += numBlockFrames * sinkBytesPerFrame;
+        framesLeft -= numBlockFrames;
+    }
+    return framesToRead;
+}
+
 int32_t AAudioFlowGraph::pull(void *destination, int32_t targetFramesToRead) {
+    if (mFused) {
+        return readFused(destination, targetFramesToRead);
+    }
     return mSink->read(destination, targetFramesToRead);
 }
 
 int32_t AAudioFlowGraph::process(const void *source, int32_t numFramesToWrite, void *destination,
                     int32_t targetFramesToRead) {
+    if (mFused) {
+        mFusedSourceData = static_cast<const uint8_t *>(source);
+        mFusedSourceFramesLeft = numFramesToWrite;
+        return readFused(destination, targetFramesToRead);
+    }
     mSource->setData(source, numFramesToWrite);
     return mSink->read(destination, targetFramesToRead);
 }
@@ -47,6 +47,7 @@ public:
      * @param useVolumeRamps
      * @param audioBalance
      * @param resamplerQuality
+     * @param allowFusedChain run the graph as a single fused pass when the topology allows it
      * @return
      */
     aaudio_result_t configure(audio_format_t sourceFormat,
@@ -58,7 +59,8 @@ public:
                               bool useMonoBlend,
                               bool useVolumeRamps,
                               float audioBalance,
-                              aaudio::resampler::MultiChannelResampler::Quality resamplerQuality);
+                              aaudio::resampler::MultiChannelResampler::Quality resamplerQuality,
+                              bool allowFusedChain = true);
 
     /**
      * Attempt to read targetFramesToRead from the flowgraph.
@@ -106,7 +108,36 @@ public:
      */
     void setRampLengthInFrames(int32_t numFrames);
 
+    /**
+     * @return true if the graph runs as a single fused pass instead of pulling through the nodes
+     */
+    bool isFused() const {
+        return mFused;
+    }
+
 private:
+    /**
+     * Run the chain as one pass over blocks of kFusedBlockFrames frames:
+     * source conversion, limiter, channel expansion, volume ramps and sink conversion.
+     * The nodes are only used to hold the state of the limiter and ramps.
+     */
+    int32_t readFused(void *destination, int32_t numFrames);
+
+    void applyVolumeRampsFused(float *buffer, int32_t numFrames);
+
+    // Much larger than kDefaultBufferSize so that the per block overhead is amortized
+    // and the conversion loops can be vectorized.
+    static constexpr int32_t kFusedBlockFrames = 256;
+
+    bool mFused = false;
+    audio_format_t mSourceFormat = AUDIO_FORMAT_INVALID;
+    audio_format_t mSinkFormat = AUDIO_FORMAT_INVALID;
+    int32_t mSourceChannelCount = 0;
+    int32_t mSinkChannelCount = 0;
+    const uint8_t *mFusedSourceData = nullptr;
+    int32_t mFusedSourceFramesLeft = 0;
+    std::unique_ptr<float[]> mFusedBuffer;
+
     std::unique_ptr<FLOWGRAPH_OUTER_NAMESPACE::flowgraph::FlowGraphSourceBuffered> mSource;
     std::unique_ptr<RESAMPLER_OUTER_NAMESPACE::resampler::MultiChannelResampler> mResampler;
     std::unique_ptr<FLOWGRAPH_OUTER_NAMESPACE::flowgraph::SampleRateConverter> mRateConverter;
@@ -35,6 +35,13 @@ public:
         return "Limiter";
     }
 
+    /**
+     * Limit numSamples samples without going through the ports.
+     * This lets a fused chain share the state of the limiter.
+     * The input and output may be the same buffer.
+     */
+    void processSamples(const float *inputBuffer, float *outputBuffer, int32_t numSamples);
+
 private:
     // These numbers are based on a polynomial spline for a quadratic solution Ax^2 + Bx + C
     // The range is up to 3 dB, (10^(3/20)), to match AudioTrack for float data.
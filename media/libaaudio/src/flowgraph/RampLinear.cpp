@@ -42,11 +42,12 @@ float RampLinear::interpolateCurrent() {
     return mLevelTo - (mRemaining * mScaler);
 }
 
-int32_t RampLinear::onProcess(int32_t numFrames) {
-    const float *inputBuffer = input.getBuffer();
-    float *outputBuffer = output.getBuffer();
-    int32_t channelCount = output.getSamplesPerFrame();
-
+void RampLinear::updateRamp() {
+    // When the ports are bypassed by applyInterleaved() the node is never pulled,
+    // so mark the ramp as used here. Otherwise setTarget() would jump to the new level.
+    if (mLastCallCount == kInitialCallCount) {
+        mLastCallCount = 0;
+    }
     float target = getTarget();
     if (target != mLevelTo) {
         // Start new ramp. Continue from previous level.
@@ -55,6 +56,36 @@ int32_t RampLinear::onProcess(int32_t numFrames) {
         mRemaining = mLengthInFrames;
         mScaler = (mLevelTo - mLevelFrom) / mLengthInFrames; // for interpolation
     }
+}
+
+void RampLinear::applyInterleaved(float *buffer, int32_t numFrames, int32_t stride) {
+    updateRamp();
+
+    int32_t framesLeft = numFrames;
+    if (mRemaining > 0) {
+        int32_t framesToRamp = std::min(framesLeft, mRemaining);
+        framesLeft -= framesToRamp;
+        while (framesToRamp > 0) {
+            *buffer *= interpolateCurrent();
+            buffer += stride;
+            mRemaining--;
+            framesToRamp--;
+        }
+    }
+
+    const float level = mLevelTo;
+    for (int i = 0; i < framesLeft; i++) {
+        *buffer *= level;
+        buffer += stride;
+    }
+}
+
+int32_t RampLinear::onProcess(int32_t numFrames) {
+    const float *inputBuffer = input.getBuffer();
+    float *outputBuffer = output.getBuffer();
+    int32_t channelCount = output.getSamplesPerFrame();
+
+    updateRamp();
 
     int32_t framesLeft = numFrames;
 
@@ -78,6 +78,36 @@ public:
         return "RampLinear";
     }
 
+    /**
+     * Start a new ramp from the current level if the target has changed.
+     * This is called by onProcess() and applyInterleaved().
+     */
+    void updateRamp();
+
+    /**
+     * @return true if a ramp started by updateRamp() is still in progress
+     */
+    bool isRamping() const {
+        return mRemaining > 0;
+    }
+
+    /**
+     * @return level that is applied once the ramp is complete
+     */
+    float getLevel() const {
+        return mLevelTo;
+    }
+
+    /**
+     * Apply the ramp in place to one channel of an interleaved buffer.
+     * This bypasses the ports so that a fused chain can share the ramp state.
+     *
+     * @param buffer first sample of the channel
+     * @param numFrames
+     * @param stride number of samples between frames, i.e. the channel count of the buffer
+     */
+    void applyInterleaved(float *buffer, int32_t numFrames, int32_t stride);
+
 private:
 
     float interpolateCurrent();
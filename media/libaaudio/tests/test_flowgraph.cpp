@@ -22,10 +22,13 @@
  */
 
 #include <iostream>
+#include <math.h>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <aaudio/AAudio.h>
+#include <audio_utils/primitives.h>
 #include "client/AAudioFlowGraph.h"
 #include "flowgraph/ClipToRange.h"
 #include "flowgraph/Limiter.h"
@@ -718,3 +721,127 @@ INSTANTIATE_TEST_SUITE_P(
                 TestFlowgraphResamplerParams({44100, 11025, MultiChannelResampler::Quality::Best})),
         &getTestName
 );
+
+// The fused chain must produce exactly the same data as the generic graph.
+void checkFusedMatchesGraph(audio_format_t sourceFormat, int32_t sourceChannelCount,
+                            audio_format_t sinkFormat, int32_t sinkChannelCount,
+                            bool useVolumeRamps) {
+    AAudioFlowGraph graphs[2];
+    for (int i = 0; i < 2; i++) {
+        aaudio_result_t result = graphs[i].configure(sourceFormat,
+                sourceChannelCount,
+                48000 /* sourceSampleRate */,
+                sinkFormat,
+                sinkChannelCount,
+                48000 /* sinkSampleRate */,
+                false /* useMonoBlend */,
+                useVolumeRamps,
+                0.5f /* audioBalance */,
+                MultiChannelResampler::Quality::Medium,
+                i == 0 /* allowFusedChain */);
+        ASSERT_EQ(AAUDIO_OK, result);
+        graphs[i].setRampLengthInFrames(100);
+    }
+    ASSERT_TRUE(graphs[0].isFused());
+    ASSERT_FALSE(graphs[1].isFused());
+
+    constexpr int kNumFrames = 1000;
+    const size_t sourceFrameSize = audio_bytes_per_frame(sourceChannelCount, sourceFormat);
+    const size_t sinkFrameSize = audio_bytes_per_frame(sinkChannelCount, sinkFormat);
+    std::vector<float> floats(kNumFrames * sourceChannelCount);
+    for (size_t i = 0; i < floats.size(); i++) {
+        floats[i] = 1.5f * sinf(i * 0.01f); // exceeds full scale to exercise clipping
+    }
+    std::vector<uint8_t> input(kNumFrames * sourceFrameSize);
+    switch (sourceFormat) {
+        case AUDIO_FORMAT_PCM_16_BIT:
+            memcpy_to_i16_from_float((int16_t *) input.data(), floats.data(), floats.size());
+            break;
+        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+            memcpy_to_p24_from_float(input.data(), floats.data(), floats.size());
+            break;
+        case AUDIO_FORMAT_PCM_32_BIT:
+            memcpy_to_i32_from_float((int32_t *) input.data(), floats.data(), floats.size());
+            break;
+        case AUDIO_FORMAT_PCM_8_24_BIT:
+            memcpy_to_q8_23_from_float_with_clamp((int32_t *) input.data(), floats.data(),
+                    floats.size());
+            break;
+        default:
+            ASSERT_EQ(AUDIO_FORMAT_PCM_FLOAT, sourceFormat);
+            memcpy(input.data(), floats.data(), input.size());
+            break;
+    }
+
+    std::vector<uint8_t> outputs[2];
+    for (int i = 0; i < 2; i++) {
+        outputs[i].resize(kNumFrames * sinkFrameSize);
+        int framesRead = 0;
+        // Vary the sizes and change the volume so that ramps happen across blocks.
+        for (int framesWritten = 0, size = 1; framesWritten < kNumFrames;
+                framesWritten += size, size = std::min(size * 3, kNumFrames - framesWritten)) {
+            graphs[i].setTargetVolume(framesWritten % 2 ? 0.25f : 0.75f);
+            framesRead += graphs[i].process(&input[framesWritten * sourceFrameSize], size,
+                    &outputs[i][framesRead * sinkFrameSize], size / 2);
+            framesRead += graphs[i].pull(&outputs[i][framesRead * sinkFrameSize],
+                    kNumFrames - framesRead);
+        }
+        ASSERT_EQ(kNumFrames, framesRead);
+    }
+    EXPECT_EQ(outputs[0], outputs[1]);
+}
+
+TEST(test_flowgraph, flowgraph_fused_float_to_i16_stereo) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_FLOAT, 2, AUDIO_FORMAT_PCM_16_BIT, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_float_to_float_limiter) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_FLOAT, 2, AUDIO_FORMAT_PCM_FLOAT, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_i16_mono_to_stereo) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_16_BIT, 1, AUDIO_FORMAT_PCM_FLOAT, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_i16_to_float_multichannel) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_16_BIT, 6, AUDIO_FORMAT_PCM_FLOAT, 6,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_i24_to_i16_stereo) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_24_BIT_PACKED, 2, AUDIO_FORMAT_PCM_16_BIT, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_float_to_i24_stereo) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_FLOAT, 2, AUDIO_FORMAT_PCM_24_BIT_PACKED, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_i32_mono_to_stereo) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_32_BIT, 1, AUDIO_FORMAT_PCM_32_BIT, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_float_to_i32_stereo) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_FLOAT, 2, AUDIO_FORMAT_PCM_32_BIT, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_i8_24_to_float_stereo) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_8_24_BIT, 2, AUDIO_FORMAT_PCM_FLOAT, 2,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_i16_to_i8_24_multichannel) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_16_BIT, 6, AUDIO_FORMAT_PCM_8_24_BIT, 6,
+            true /* useVolumeRamps */);
+}
+
+TEST(test_flowgraph, flowgraph_fused_no_ramps) {
+    checkFusedMatchesGraph(AUDIO_FORMAT_PCM_16_BIT, 2, AUDIO_FORMAT_PCM_FLOAT, 2,
+            false /* useVolumeRamps */);
+}
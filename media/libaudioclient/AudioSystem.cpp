@@ -31,8 +31,13 @@
 #include <media/IAudioFlinger.h>
 #include <media/PolicyAidlConversion.h>
 #include <media/TypeConverter.h>
+#include <mediautils/ServiceUtilities.h>
 #include <math.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include <system/audio.h>
 #include <android/media/GetInputForAttrResponse.h>
 #include <android/media/AudioMixerAttributesInternal.h>
@@ -74,6 +79,123 @@ record_config_callback AudioSystem::gRecordConfigCallback = NULL;
 routing_callback AudioSystem::gRoutingCallback = NULL;
 vol_range_init_req_callback AudioSystem::gVolRangeInitReqCallback = NULL;
 
+// Client side cache of audio policy queries that audio managers issue in tight loops.
+// Results are dropped when audioserver notifies a change that may affect them, and when this
+// process makes such a change itself, since that notification arrives asynchronously.
+// A result obtained while the cache was invalidated is not stored, see generation().
+// Routing queries (outputs, devices for attributes) are not cached: the engine's answer
+// depends on playback activity and its timing, which nothing notifies.
+class PolicyQueryCache {
+public:
+    enum Scope {
+        VOLUMES = 1,        // volume indexes
+        ALL = 2 | VOLUMES,  // also strategies, which only change when audioserver restarts
+    };
+
+    // To be read before querying audioserver, and passed to the put*() method.
+    uint64_t generation() {
+        std::lock_guard _l(mLock);
+        return mGeneration;
+    }
+
+    void invalidate(Scope scope) {
+        std::lock_guard _l(mLock);
+        ++mGeneration;
+        mVolumeIndexes.clear();
+        if ((scope & ALL) == ALL) {
+            mStrategies.clear();
+        }
+    }
+
+    bool getStrategy(audio_stream_type_t stream, product_strategy_t* strategy) {
+        return get(mStrategies, stream, strategy);
+    }
+    void putStrategy(uint64_t generation, audio_stream_type_t stream,
+                     product_strategy_t strategy) {
+        put(mStrategies, generation, stream, strategy);
+    }
+
+    bool getVolumeIndex(const audio_attributes_t& attr, audio_devices_t device, int* index) {
+        return get(mVolumeIndexes, std::make_pair(AttributesKey(attr), device), index);
+    }
+    void putVolumeIndex(uint64_t generation, const audio_attributes_t& attr,
+                        audio_devices_t device, int index) {
+        put(mVolumeIndexes, generation, std::make_pair(AttributesKey(attr), device), index);
+    }
+
+    void getStats(uint64_t* hits, uint64_t* misses) {
+        std::lock_guard _l(mLock);
+        *hits = mHits;
+        *misses = mMisses;
+    }
+
+private:
+    // audio_attributes_t without the bytes following the tags' terminator.
+    struct AttributesKey {
+        explicit AttributesKey(const audio_attributes_t& attr)
+            : contentType(attr.content_type), usage(attr.usage), source(attr.source),
+              flags(attr.flags), tags(attr.tags, strnlen(attr.tags, sizeof(attr.tags))) {}
+
+        bool operator<(const AttributesKey& other) const {
+            return std::tie(contentType, usage, source, flags, tags)
+                    < std::tie(other.contentType, other.usage, other.source, other.flags,
+                               other.tags);
+        }
+
+        audio_content_type_t contentType;
+        audio_usage_t usage;
+        audio_source_t source;
+        audio_flags_mask_t flags;
+        std::string tags;
+    };
+
+    template <typename Map>
+    bool get(const Map& map, const typename Map::key_type& key,
+             typename Map::mapped_type* value) {
+        std::lock_guard _l(mLock);
+        auto it = map.find(key);
+        if (it == map.end()) {
+            ++mMisses;
+            return false;
+        }
+        ++mHits;
+        *value = it->second;
+        return true;
+    }
+
+    template <typename Map>
+    void put(Map& map, uint64_t generation, const typename Map::key_type& key,
+             const typename Map::mapped_type& value) {
+        std::lock_guard _l(mLock);
+        if (generation == mGeneration) {
+            map[key] = value;
+        }
+    }
+
+    std::mutex mLock;
+    uint64_t mGeneration = 0;
+    uint64_t mHits = 0;
+    uint64_t mMisses = 0;
+    std::map<audio_stream_type_t, product_strategy_t> mStrategies;
+    std::map<std::pair<AttributesKey, audio_devices_t>, int> mVolumeIndexes;
+};
+
+static PolicyQueryCache gPolicyQueryCache;
+
+// Whether this process may cache volume queries: cached indexes must be dropped on volume
+// range init requests, which audioserver only sends to service uids, see
+// AudioPolicyService::NotificationClient::onVolumeRangeInitRequest().
+static bool volumeQueryCacheAllowedForUid() {
+    static const bool serviceUid = isServiceUid(getuid());
+    return serviceUid;
+}
+
+// Called with the result of a request changing volumes. Returns |status|.
+static status_t invalidatePolicyQueries(PolicyQueryCache::Scope scope, status_t status) {
+    gPolicyQueryCache.invalidate(scope);
+    return status;
+}
+
 // Required to be held while calling into gSoundTriggerCaptureStateListener.
 class CaptureStateListenerImpl;
 
@@ -907,8 +1029,21 @@ const sp<IAudioPolicyService> AudioSystem::get_audio_policy_service() {
 }
 
 void AudioSystem::clearAudioPolicyService() {
+    {
+        Mutex::Autolock _l(gLockAPS);
+        gAudioPolicyService.clear();
+    }
+    gPolicyQueryCache.invalidate(PolicyQueryCache::ALL);
+}
+
+bool AudioSystem::canCacheVolumeQueries() {
     Mutex::Autolock _l(gLockAPS);
-    gAudioPolicyService.clear();
+    return volumeQueryCacheAllowedForUid() && gAudioPolicyServiceClient != 0
+            && gAudioPolicyServiceClient->isAudioVolumeGroupCbEnabled();
+}
+
+void AudioSystem::getPolicyQueryCacheStats(uint64_t* hits, uint64_t* misses) {
+    gPolicyQueryCache.getStats(hits, misses);
 }
 
 // ---------------------------------------------------------------------------
@@ -1247,8 +1382,9 @@ status_t AudioSystem::initStreamVolume(audio_stream_type_t stream,
             legacy2aidl_audio_stream_type_t_AudioStreamType(stream));
     int32_t indexMinAidl = VALUE_OR_RETURN_STATUS(convertIntegral<int32_t>(indexMin));
     int32_t indexMaxAidl = VALUE_OR_RETURN_STATUS(convertIntegral<int32_t>(indexMax));
-    status_t status = statusTFromBinderStatus(
-            aps->initStreamVolume(streamAidl, indexMinAidl, indexMaxAidl));
+    status_t status = invalidatePolicyQueries(PolicyQueryCache::VOLUMES,
+            statusTFromBinderStatus(
+                    aps->initStreamVolume(streamAidl, indexMinAidl, indexMaxAidl)));
     if (status == DEAD_OBJECT) {
         // This is a critical operation since w/o proper stream volumes no audio
         // will be heard. Make sure we recover from a failure in any case.
@@ -1269,8 +1405,8 @@ status_t AudioSystem::setStreamVolumeIndex(audio_stream_type_t stream,
     int32_t indexAidl = VALUE_OR_RETURN_STATUS(convertIntegral<int32_t>(index));
     AudioDeviceDescription deviceAidl = VALUE_OR_RETURN_STATUS(
             legacy2aidl_audio_devices_t_AudioDeviceDescription(device));
-    return statusTFromBinderStatus(
-            aps->setStreamVolumeIndex(streamAidl, deviceAidl, indexAidl));
+    return invalidatePolicyQueries(PolicyQueryCache::VOLUMES, statusTFromBinderStatus(
+            aps->setStreamVolumeIndex(streamAidl, deviceAidl, indexAidl)));
 }
 
 status_t AudioSystem::getStreamVolumeIndex(audio_stream_type_t stream,
@@ -1303,13 +1439,19 @@ status_t AudioSystem::setVolumeIndexForAttributes(const audio_attributes_t& attr
     int32_t indexAidl = VALUE_OR_RETURN_STATUS(convertIntegral<int32_t>(index));
     AudioDeviceDescription deviceAidl = VALUE_OR_RETURN_STATUS(
             legacy2aidl_audio_devices_t_AudioDeviceDescription(device));
-    return statusTFromBinderStatus(
-            aps->setVolumeIndexForAttributes(attrAidl, deviceAidl, indexAidl));
+    return invalidatePolicyQueries(PolicyQueryCache::VOLUMES, statusTFromBinderStatus(
+            aps->setVolumeIndexForAttributes(attrAidl, deviceAidl, indexAidl)));
 }
 
 status_t AudioSystem::getVolumeIndexForAttributes(const audio_attributes_t& attr,
                                                   int& index,
                                                   audio_devices_t device) {
+    // Read first, so that a result obtained as volume callbacks get disabled is not stored.
+    const uint64_t generation = gPolicyQueryCache.generation();
+    const bool cacheable = canCacheVolumeQueries();
+    if (cacheable && gPolicyQueryCache.getVolumeIndex(attr, device, &index)) {
+        return OK;
+    }
     const sp<IAudioPolicyService>& aps = AudioSystem::get_audio_policy_service();
     if (aps == 0) return PERMISSION_DENIED;
 
@@ -1321,6 +1463,9 @@ status_t AudioSystem::getVolumeIndexForAttributes(const audio_attributes_t& attr
     RETURN_STATUS_IF_ERROR(statusTFromBinderStatus(
             aps->getVolumeIndexForAttributes(attrAidl, deviceAidl, &indexAidl)));
     index = VALUE_OR_RETURN_STATUS(convertIntegral<int>(indexAidl));
+    if (cacheable) {
+        gPolicyQueryCache.putVolumeIndex(generation, attr, device, index);
+    }
     return OK;
 }
 
@@ -1351,6 +1496,11 @@ status_t AudioSystem::getMinVolumeIndexForAttributes(const audio_attributes_t& a
 }
 
 product_strategy_t AudioSystem::getStrategyForStream(audio_stream_type_t stream) {
+    const uint64_t generation = gPolicyQueryCache.generation();
+    product_strategy_t strategy;
+    if (gPolicyQueryCache.getStrategy(stream, &strategy)) {
+        return strategy;
+    }
     const sp<IAudioPolicyService>& aps = AudioSystem::get_audio_policy_service();
     if (aps == 0) return PRODUCT_STRATEGY_NONE;
 
@@ -1362,6 +1512,9 @@ product_strategy_t AudioSystem::getStrategyForStream(audio_stream_type_t stream)
                 aps->getStrategyForStream(streamAidl, &resultAidl)));
         return aidl2legacy_int32_t_product_strategy_t(resultAidl);
     }();
+    if (result.ok()) {
+        gPolicyQueryCache.putStrategy(generation, stream, result.value());
+    }
     return result.value_or(PRODUCT_STRATEGY_NONE);
 }
 
@@ -1717,6 +1870,7 @@ status_t AudioSystem::addAudioVolumeGroupCallback(const sp<AudioVolumeGroupCallb
     int ret = gAudioPolicyServiceClient->addAudioVolumeGroupCallback(callback);
     if (ret == 1) {
         aps->setAudioVolumeGroupCallbacksEnabled(true);
+        gPolicyQueryCache.invalidate(PolicyQueryCache::VOLUMES);
     }
     return (ret < 0) ? INVALID_OPERATION : NO_ERROR;
 }
@@ -1732,6 +1886,8 @@ status_t AudioSystem::removeAudioVolumeGroupCallback(const sp<AudioVolumeGroupCa
     int ret = gAudioPolicyServiceClient->removeAudioVolumeGroupCallback(callback);
     if (ret == 0) {
         aps->setAudioVolumeGroupCallbacksEnabled(false);
+        // Volume changes are no longer notified from now on.
+        gPolicyQueryCache.invalidate(PolicyQueryCache::VOLUMES);
     }
     return (ret < 0) ? INVALID_OPERATION : NO_ERROR;
 }
@@ -2811,6 +2967,7 @@ Status AudioSystem::AudioPolicyServiceClient::onAudioVolumeGroupChanged(int32_t
             aidl2legacy_int32_t_volume_group_t(group));
     int flagsLegacy = VALUE_OR_RETURN_BINDER_STATUS(convertReinterpret<int>(flags));
 
+    gPolicyQueryCache.invalidate(PolicyQueryCache::VOLUMES);
     Mutex::Autolock _l(mLock);
     for (size_t i = 0; i < mAudioVolumeGroupCallback.size(); i++) {
         mAudioVolumeGroupCallback[i]->onAudioVolumeGroupChanged(groupLegacy, flagsLegacy);
@@ -2892,6 +3049,7 @@ Status AudioSystem::AudioPolicyServiceClient::onRoutingUpdated() {
 }
 
 Status AudioSystem::AudioPolicyServiceClient::onVolumeRangeInitRequest() {
+    gPolicyQueryCache.invalidate(PolicyQueryCache::VOLUMES);
     vol_range_init_req_callback cb = NULL;
     {
         Mutex::Autolock _l(AudioSystem::gLock);
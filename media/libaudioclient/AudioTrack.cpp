@@ -2024,6 +2024,10 @@ status_t AudioTrack::createTrack_l()
         mStaticProxy = new StaticAudioTrackClientProxy(cblk, buffers, mFrameCount, mFrameSize);
         mProxy = mStaticProxy;
     }
+    // fast tracks are serviced every few ms, so a short spin often beats a futex round trip,
+    // but only if the server can run meanwhile
+    mProxy->setSpinBeforeWait((mFlags & AUDIO_OUTPUT_FLAG_FAST) != 0
+            && std::thread::hardware_concurrency() > 1);
 
     mProxy->setVolumeLR(gain_minifloat_pack(
             gain_from_float(mVolume[AUDIO_INTERLEAVE_LEFT]),
@@ -2304,6 +2308,12 @@ void AudioTrack::restartIfDisabled()
 // -------------------------------------------------------------------------
 
 ssize_t AudioTrack::write(const void* buffer, size_t userSize, bool blocking)
+{
+    struct iovec iov = { const_cast<void*>(buffer), userSize };
+    return writev(&iov, 1, blocking);
+}
+
+ssize_t AudioTrack::writev(const struct iovec* iov, int iovcnt, bool blocking)
 {
     if (mTransfer != TRANSFER_SYNC && mTransfer != TRANSFER_SYNC_NOTIF_CALLBACK) {
         return INVALID_OPERATION;
@@ -2319,16 +2329,28 @@ ssize_t AudioTrack::write(const void* buffer, size_t userSize, bool blocking)
         }
     }
 
-    if (ssize_t(userSize) < 0 || (buffer == NULL && userSize != 0)) {
-        // Validation: user is most-likely passing an error code, and it would
-        // make the return value ambiguous (actualSize vs error).
-        ALOGE("%s(%d): AudioTrack::write(buffer=%p, size=%zu (%zd)",
-                __func__, mPortId, buffer, userSize, userSize);
+    if (iovcnt < 0 || (iov == NULL && iovcnt != 0)) {
+        ALOGE("%s(%d): iov=%p, iovcnt=%d", __func__, mPortId, iov, iovcnt);
         return BAD_VALUE;
     }
+    size_t userSize = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        const size_t size = iov[i].iov_len;
+        userSize += size;
+        if (ssize_t(size) < 0 || ssize_t(userSize) < 0
+                || (iov[i].iov_base == NULL && size != 0)) {
+            // Validation: user is most-likely passing an error code, and it would
+            // make the return value ambiguous (actualSize vs error).
+            ALOGE("%s(%d): AudioTrack::write(buffer=%p, size=%zu (%zd)",
+                    __func__, mPortId, iov[i].iov_base, size, size);
+            return BAD_VALUE;
+        }
+    }
 
     size_t written = 0;
     Buffer audioBuffer;
+    int index = 0;      // iov being copied from
+    size_t offset = 0;  // into iov[index]
 
     while (userSize >= mFrameSize) {
         audioBuffer.frameCount = userSize / mFrameSize;
@@ -2346,8 +2368,18 @@ ssize_t AudioTrack::write(const void* buffer, size_t userSize, bool blocking)
         }
 
         size_t toWrite = audioBuffer.size();
-        memcpy(audioBuffer.raw, buffer, toWrite);
-        buffer = ((const char *) buffer) + toWrite;
+        for (size_t copied = 0; copied < toWrite; ) {
+            if (offset == iov[index].iov_len) {
+                ++index;
+                offset = 0;
+                continue;
+            }
+            const size_t toCopy = std::min(toWrite - copied, iov[index].iov_len - offset);
+            memcpy((char *) audioBuffer.raw + copied,
+                    (const char *) iov[index].iov_base + offset, toCopy);
+            copied += toCopy;
+            offset += toCopy;
+        }
         userSize -= toWrite;
         written += toWrite;
 
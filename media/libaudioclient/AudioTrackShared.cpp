@@ -108,6 +108,9 @@ uint32_t Proxy::setStartThresholdInFrames(uint32_t startThresholdInFrames)
 ClientProxy::ClientProxy(audio_track_cblk_t* cblk, void *buffers, size_t frameCount,
         size_t frameSize, bool isOut, bool clientInServer)
     : Proxy(cblk, buffers, frameCount, frameSize, isOut, clientInServer)
+    , mSpinNs(0)
+    , mSpins(0)
+    , mSpinsWoken(0)
     , mEpoch(0)
     , mTimestampObserver(&cblk->mExtendedTimestampQueue)
 {
@@ -119,6 +122,50 @@ const struct timespec ClientProxy::kNonBlocking = {0 /*tv_sec*/, 0 /*tv_nsec*/};
 
 #define MEASURE_NS 10000000 // attempt to provide accurate timeouts if requested >= MEASURE_NS
 
+static inline void cpuRelax()
+{
+#if defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+bool ClientProxy::spinForWake()
+{
+    audio_track_cblk_t* cblk = mCblk;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool woken = false;
+    for (int i = 1; ; ++i) {
+        if (android_atomic_acquire_load(&cblk->mFutex) & CBLK_FUTEX_WAKE) {
+            woken = true;
+            break;
+        }
+        cpuRelax();
+        // reading the clock costs more than a relax, so only do so occasionally
+        if ((i & 15) == 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if ((now.tv_sec - start.tv_sec) * 1000000000LL + now.tv_nsec - start.tv_nsec
+                    >= mSpinNs) {
+                break;
+            }
+        }
+    }
+    // Spin longer while it pays off, back off when the server is not that quick.
+    mSpins++;
+    if (woken) {
+        mSpinsWoken++;
+        mSpinNs = std::min(mSpinNs * 2, kMaxSpinNs);
+    } else {
+        mSpinNs = std::max(mSpinNs / 2, kMinSpinNs);
+    }
+    return woken;
+}
+
 // To facilitate quicker recovery from server failure, this value limits the timeout per each futex
 // wait.  However it does not protect infinite timeouts.  If defined to be zero, there is no limit.
 // FIXME May not be compatible with audio tunneling requirements where timeout should be in the
@@ -180,6 +227,7 @@ status_t ClientProxy::obtainBuffer(Buffer* buffer, const struct timespec *reques
     bool beforeIsValid = false;
     audio_track_cblk_t* cblk = mCblk;
     bool ignoreInitialPendingInterrupt = true;
+    bool spun = false;
     // check for shared memory corruption
     if (mIsShutdown) {
         status = NO_INIT;
@@ -311,15 +359,30 @@ status_t ClientProxy::obtainBuffer(Buffer* buffer, const struct timespec *reques
             break;
         }
         int32_t old = android_atomic_and(~CBLK_FUTEX_WAKE, &cblk->mFutex);
+        if (!(old & CBLK_FUTEX_WAKE) && mSpinNs > 0 && !spun) {
+            // Only spin once the flag was found clear: it stays set after a release until
+            // we clear it, so a set flag seen while spinning is then a new release.
+            spun = true;
+            if (spinForWake()) {
+                old = android_atomic_and(~CBLK_FUTEX_WAKE, &cblk->mFutex);
+            }
+        }
         if (!(old & CBLK_FUTEX_WAKE)) {
             if (measure && !beforeIsValid) {
                 clock_gettime(CLOCK_MONOTONIC, &before);
                 beforeIsValid = true;
             }
             errno = 0;
-            (void) syscall(__NR_futex, &cblk->mFutex,
-                    mClientInServer ? FUTEX_WAIT_PRIVATE : FUTEX_WAIT, old & ~CBLK_FUTEX_WAKE, ts);
+            // Announce the wait, so that the server wakes us. If it set CBLK_FUTEX_WAKE
+            // meanwhile, it may not have seen CBLK_FUTEX_WAITER, so don't wait.
+            old = android_atomic_or(CBLK_FUTEX_WAITER, &cblk->mFutex);
+            if (!(old & CBLK_FUTEX_WAKE)) {
+                (void) syscall(__NR_futex, &cblk->mFutex,
+                        mClientInServer ? FUTEX_WAIT_PRIVATE : FUTEX_WAIT,
+                        old | CBLK_FUTEX_WAITER, ts);
+            }
             status_t error = errno; // clock_gettime can affect errno
+            android_atomic_and(~CBLK_FUTEX_WAITER, &cblk->mFutex);
             // update total elapsed time spent waiting
             if (measure) {
                 struct timespec after;
@@ -768,7 +831,8 @@ void ServerProxy::flushBufferIfNeeded()
         // There is no danger from a false positive, so err on the side of caution
         if (true /*front != newFront*/) {
             int32_t old = android_atomic_or(CBLK_FUTEX_WAKE, &cblk->mFutex);
-            if (!(old & CBLK_FUTEX_WAKE)) {
+            // no FUTEX_WAKE needed unless the client waits, it will see CBLK_FUTEX_WAKE
+            if (!(old & CBLK_FUTEX_WAKE) && (old & CBLK_FUTEX_WAITER)) {
                 (void) syscall(__NR_futex, &cblk->mFutex,
                         mClientInServer ? FUTEX_WAKE_PRIVATE : FUTEX_WAKE, INT_MAX);
             }
@@ -938,7 +1002,8 @@ void ServerProxy::releaseBuffer(Buffer* buffer)
     if (!mIsOut || (mAvailToClient + stepCount >= minimum)) {
         ALOGV("mAvailToClient=%zu stepCount=%zu minimum=%zu", mAvailToClient, stepCount, minimum);
         int32_t old = android_atomic_or(CBLK_FUTEX_WAKE, &cblk->mFutex);
-        if (!(old & CBLK_FUTEX_WAKE)) {
+        // no FUTEX_WAKE needed unless the client waits, it will see CBLK_FUTEX_WAKE
+        if (!(old & CBLK_FUTEX_WAKE) && (old & CBLK_FUTEX_WAITER)) {
             (void) syscall(__NR_futex, &cblk->mFutex,
                     mClientInServer ? FUTEX_WAKE_PRIVATE : FUTEX_WAKE, INT_MAX);
         }
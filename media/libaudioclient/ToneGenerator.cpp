@@ -1429,14 +1429,7 @@ size_t ToneGenerator::onMoreData(const AudioTrack::Buffer& buffer) {
             // If segment,  ON -> OFF transition : ramp volume down
             if (mpToneDesc->segments[mCurSegment].waveFreq[0] != 0) {
                 lWaveCmd = WaveGenerator::WAVEGEN_STOP;
-                unsigned int lFreqIdx = 0;
-                uint16_t lFrequency = mpToneDesc->segments[mCurSegment].waveFreq[lFreqIdx];
-
-                while (lFrequency != 0) {
-                    WaveGenerator *lpWaveGen = mWaveGens.valueFor(lFrequency);
-                    lpWaveGen->getSamples(lpOut, lGenSmp, lWaveCmd);
-                    lFrequency = mpToneDesc->segments[mCurSegment].waveFreq[++lFreqIdx];
-                }
+                generateWaves(lpOut, lGenSmp, lWaveCmd);
                 ALOGV("ON->OFF, lGenSmp: %d, lReqSmp: %d", lGenSmp, lReqSmp);
             }
 
@@ -1520,14 +1513,7 @@ size_t ToneGenerator::onMoreData(const AudioTrack::Buffer& buffer) {
 
         if (lGenSmp) {
             // If samples must be generated, call all active wave generators and acumulate waves in lpOut
-            unsigned int lFreqIdx = 0;
-            uint16_t lFrequency = mpToneDesc->segments[mCurSegment].waveFreq[lFreqIdx];
-
-            while (lFrequency != 0) {
-                WaveGenerator *lpWaveGen = mWaveGens.valueFor(lFrequency);
-                lpWaveGen->getSamples(lpOut, lGenSmp, lWaveCmd);
-                lFrequency = mpToneDesc->segments[mCurSegment].waveFreq[++lFreqIdx];
-            }
+            generateWaves(lpOut, lGenSmp, lWaveCmd);
         }
 
         lNumSmp -= lReqSmp;
@@ -1659,6 +1645,44 @@ bool ToneGenerator::prepareWave() {
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//    Method:        ToneGenerator::generateWaves()
+//
+//    Description:    Runs all wave generators of the current tone segment and accumulates
+//      their output in outBuffer. Generators are run in pairs so that a DTMF segment
+//      is synthesized in a single pass over the buffer.
+//
+//    Input:
+//        outBuffer:      Output buffer where to accumulate samples.
+//        count:          number of samples to produce.
+//        command:        special action requested (see WaveGenerator::gen_command).
+//
+//    Output:
+//        none
+//
+////////////////////////////////////////////////////////////////////////////////
+void ToneGenerator::generateWaves(int16_t *outBuffer, unsigned int count, unsigned int command) {
+    const uint16_t *lpFreq = mpToneDesc->segments[mCurSegment].waveFreq;
+
+    while (lpFreq[0] != 0) {
+        WaveGenerator *lpWaveGen1 = mWaveGens.valueFor(lpFreq[0]);
+        if (lpFreq[1] == 0) {
+            lpWaveGen1->getSamples(outBuffer, count, command);
+            break;
+        }
+        WaveGenerator *lpWaveGen2 = mWaveGens.valueFor(lpFreq[1]);
+        if (lpWaveGen1 == lpWaveGen2) {
+            // Same frequency listed twice: the second run continues from the first one's state
+            lpWaveGen1->getSamples(outBuffer, count, command);
+            lpWaveGen2->getSamples(outBuffer, count, command);
+        } else {
+            WaveGenerator::getSamples(lpWaveGen1, lpWaveGen2, outBuffer, count, command);
+        }
+        lpFreq += 2;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //    Method:        ToneGenerator::numWaves()
@@ -1867,4 +1891,94 @@ void ToneGenerator::WaveGenerator::getSamples(int16_t *outBuffer,
     mS2 = lS2;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//    Method:        WaveGenerator::getSamples()
+//
+//    Description:    Generates count samples of the sum of two sine waves and
+//        accumulates result in outBuffer. The output is identical to calling
+//        gen1->getSamples() then gen2->getSamples() on the same buffer.
+//
+//    Input:
+//        gen1, gen2:     Wave generators to run.
+//        outBuffer:      Output buffer where to accumulate samples.
+//        count:          number of samples to produce.
+//        command:        special action requested (see enum gen_command).
+//
+//    Output:
+//        none
+//
+////////////////////////////////////////////////////////////////////////////////
+void ToneGenerator::WaveGenerator::getSamples(WaveGenerator *gen1, WaveGenerator *gen2,
+        int16_t *outBuffer, unsigned int count, unsigned int command) {
+    long lS1a, lS2a, lS1b, lS2b;
+    long lA1a, lA1b, lAmplitudeA, lAmplitudeB;
+    long SampleA, SampleB;  // current samples
+
+    // init local
+    if (command == WAVEGEN_START) {
+        lS1a = (long)0;
+        lS2a = (long)gen1->mS2_0;
+        lS1b = (long)0;
+        lS2b = (long)gen2->mS2_0;
+    } else {
+        lS1a = gen1->mS1;
+        lS2a = gen1->mS2;
+        lS1b = gen2->mS1;
+        lS2b = gen2->mS2;
+    }
+    lA1a = (long)gen1->mA1_Q14;
+    lA1b = (long)gen2->mA1_Q14;
+    lAmplitudeA = (long)gen1->mAmplitude_Q15;
+    lAmplitudeB = (long)gen2->mAmplitude_Q15;
+
+    if (command == WAVEGEN_STOP) {
+        lAmplitudeA <<= 16;
+        lAmplitudeB <<= 16;
+        if (count == 0) {
+            return;
+        }
+        long decA = lAmplitudeA/count;
+        long decB = lAmplitudeB/count;
+        // loop generation
+        while (count) {
+            count--;
+            SampleA = ((lA1a * lS1a) >> S_Q14) - lS2a;
+            SampleB = ((lA1b * lS1b) >> S_Q14) - lS2b;
+            // shift delay
+            lS2a = lS1a;
+            lS1a = SampleA;
+            lS2b = lS1b;
+            lS1b = SampleB;
+            SampleA = ((lAmplitudeA>>16) * SampleA) >> S_Q15;
+            SampleB = ((lAmplitudeB>>16) * SampleB) >> S_Q15;
+            // int16_t accumulation wraps, so summing both waves first gives the same result
+            *(outBuffer++) += (int16_t)((int16_t)SampleA + (int16_t)SampleB);
+            lAmplitudeA -= decA;
+            lAmplitudeB -= decB;
+        }
+    } else {
+        // loop generation
+        while (count) {
+            count--;
+            SampleA = ((lA1a * lS1a) >> S_Q14) - lS2a;
+            SampleB = ((lA1b * lS1b) >> S_Q14) - lS2b;
+            // shift delay
+            lS2a = lS1a;
+            lS1a = SampleA;
+            lS2b = lS1b;
+            lS1b = SampleB;
+            SampleA = (lAmplitudeA * SampleA) >> S_Q15;
+            SampleB = (lAmplitudeB * SampleB) >> S_Q15;
+            *(outBuffer++) += (int16_t)((int16_t)SampleA + (int16_t)SampleB);
+        }
+    }
+
+    // save status
+    gen1->mS1 = lS1a;
+    gen1->mS2 = lS2a;
+    gen2->mS1 = lS1b;
+    gen2->mS2 = lS2b;
+}
+
 }  // end namespace android
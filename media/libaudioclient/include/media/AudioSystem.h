@@ -405,6 +405,10 @@ public:
     static const sp<media::IAudioPolicyService> get_audio_policy_service();
     static void clearAudioPolicyService();
 
+    // Number of audio policy queries answered from, and missing in, the client side cache
+    // of getStrategyForStream() and getVolumeIndexForAttributes() results.
+    static void getPolicyQueryCacheStats(uint64_t* hits, uint64_t* misses);
+
     // helpers for android.media.AudioManager.getProperty(), see description there for meaning
     static uint32_t getPrimaryOutputSamplingRate();
     static size_t getPrimaryOutputFrameCount();
@@ -776,6 +780,10 @@ public:
 
 private:
 
+    // Whether volume queries may be cached: audioserver only notifies volume changes
+    // while volume group callbacks are enabled.
+    static bool canCacheVolumeQueries();
+
     class AudioFlingerClient: public IBinder::DeathRecipient, public media::BnAudioFlingerClient
     {
     public:
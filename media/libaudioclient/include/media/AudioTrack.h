@@ -27,6 +27,7 @@
 #include <media/Modulo.h>
 #include <media/VolumeShaper.h>
 #include <utils/threads.h>
+#include <sys/uio.h>
 #include <android/content/AttributionSourceState.h>
 
 #include <chrono>
@@ -962,6 +963,12 @@ public:
      */
             ssize_t     write(const void* buffer, size_t size, bool blocking = true);
 
+    /* As write(), but gathers the data from 'iovcnt' buffers, written back to back as if
+     * they were one. Several small buffers are copied into the audio buffer with a single
+     * obtainBuffer()/releaseBuffer(), rather than once each.
+     */
+            ssize_t     writev(const struct iovec* iov, int iovcnt, bool blocking = true);
+
     /*
      * Dumps the state of an audio track.
      * Not a general-purpose API; intended only for use by media player service to dump its tracks.
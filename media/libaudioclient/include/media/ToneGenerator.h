@@ -323,6 +323,7 @@ private:
     static void audioCallback(int event, void* user, void *info);
     bool prepareWave();
     unsigned int numWaves(unsigned int segmentIdx);
+    void generateWaves(int16_t *outBuffer, unsigned int count, unsigned int command);
     void clearWaveGens();
     tone_type getToneForRegion(tone_type toneType);
 
@@ -341,6 +342,11 @@ private:
 
         void getSamples(int16_t *outBuffer, unsigned int count,
                 unsigned int command);
+        // Same as getSamples() for two generators at once: both recursions are
+        // independent, so interleaving them halves the number of passes over outBuffer
+        // and lets the CPU overlap their multiply chains.
+        static void getSamples(WaveGenerator *gen1, WaveGenerator *gen2,
+                int16_t *outBuffer, unsigned int count, unsigned int command);
 
     private:
         static const int16_t GEN_AMP = 32000;  // amplitude of generator
@@ -356,6 +362,9 @@ private:
 
     KeyedVector<uint16_t, WaveGenerator *> mWaveGens;  // list of active wave generators.
 
+    // Gives tests and benchmarks access to WaveGenerator.
+    friend class WaveGeneratorTestPeer;
+
     std::string mOpPackageName;
 };
 
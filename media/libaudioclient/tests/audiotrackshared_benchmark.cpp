@@ -0,0 +1,134 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <private/media/AudioTrackShared.h>
+
+using namespace android;
+
+namespace {
+
+constexpr size_t kFrameCount = 256;  // typical for a fast track
+constexpr size_t kFrameSize = 4;     // stereo 16 bit
+constexpr size_t kFramesPerTransfer = 64;
+
+// A playback control block and buffer in ordinary memory, used by a client and a server
+// proxy within this process as AudioFlinger's OutputTrack does.
+class SharedTrack {
+public:
+    explicit SharedTrack(bool spin)
+        : mMemory(sizeof(audio_track_cblk_t) + kFrameCount * kFrameSize) {
+        mCblk = new (mMemory.data()) audio_track_cblk_t();
+        void* buffers = mMemory.data() + sizeof(audio_track_cblk_t);
+        mClient = new AudioTrackClientProxy(
+                mCblk, buffers, kFrameCount, kFrameSize, true /* clientInServer */);
+        mClient->setSpinBeforeWait(spin);
+        mServer = new AudioTrackServerProxy(
+                mCblk, buffers, kFrameCount, kFrameSize, true /* clientInServer */,
+                48000 /* sampleRate */);
+    }
+
+    ~SharedTrack() {
+        mClient.clear();
+        mServer.clear();
+        mCblk->~audio_track_cblk_t();
+    }
+
+    // Returns the number of frames transferred, 0 if none could be without blocking.
+    size_t clientTransfer(const struct timespec* requested) {
+        Proxy::Buffer buffer;
+        buffer.mFrameCount = kFramesPerTransfer;
+        if (mClient->obtainBuffer(&buffer, requested) != NO_ERROR) {
+            return 0;
+        }
+        const size_t frames = buffer.mFrameCount;
+        mClient->releaseBuffer(&buffer);
+        return frames;
+    }
+
+    void getSpinStats(uint32_t* spins, uint32_t* woken) const {
+        mClient->getSpinStats(spins, woken);
+    }
+
+    size_t serverTransfer() {
+        Proxy::Buffer buffer;
+        buffer.mFrameCount = kFramesPerTransfer;
+        if (mServer->obtainBuffer(&buffer) != NO_ERROR || buffer.mFrameCount == 0) {
+            return 0;
+        }
+        const size_t frames = buffer.mFrameCount;
+        mServer->releaseBuffer(&buffer);
+        return frames;
+    }
+
+private:
+    std::vector<uint8_t> mMemory;
+    audio_track_cblk_t* mCblk;
+    sp<AudioTrackClientProxy> mClient;
+    sp<AudioTrackServerProxy> mServer;
+};
+
+// Client and server take turns on one thread, so the client never waits: this is the
+// obtain/release cost itself, including any FUTEX_WAKE the server issues.
+void BM_ObtainReleaseUncontended(benchmark::State& state) {
+    SharedTrack track(false /* spin */);
+    size_t frames = 0;
+    for (auto _ : state) {
+        frames += track.clientTransfer(&ClientProxy::kNonBlocking);
+        track.serverTransfer();
+    }
+    state.SetItemsProcessed(frames);
+}
+
+BENCHMARK(BM_ObtainReleaseUncontended);
+
+// The server drains the buffer on another thread as fast as it can, the client writes with
+// an infinite timeout, so it mostly finds the buffer full: this is the round trip through
+// a wait and a wake. Arg is whether the client spins before waiting.
+void BM_ObtainReleaseBlocking(benchmark::State& state) {
+    SharedTrack track(state.range(0) != 0);
+    std::atomic<bool> done{false};
+    std::thread server([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            if (track.serverTransfer() == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    size_t frames = 0;
+    for (auto _ : state) {
+        frames += track.clientTransfer(&ClientProxy::kForever);
+    }
+    done = true;
+    server.join();
+    state.SetItemsProcessed(frames);
+    // How often the client spun, and how often the server released while it did.
+    uint32_t spins, woken;
+    track.getSpinStats(&spins, &woken);
+    state.counters["spins"] = benchmark::Counter(spins, benchmark::Counter::kAvgIterations);
+    state.counters["woken"] = benchmark::Counter(woken, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ObtainReleaseBlocking)->Arg(0)->Arg(1);
+
+}  // namespace
+
+BENCHMARK_MAIN();
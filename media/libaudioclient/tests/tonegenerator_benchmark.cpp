@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "tonegenerator_test_peer.h"
+
+using namespace android;
+
+namespace {
+
+constexpr uint32_t kSampleRate = 48000;
+constexpr unsigned int kFrameCount = 960;  // one 20 ms AudioTrack callback
+
+// A DTMF digit rendered one callback at a time, both waves one after the other.
+void BM_WaveGeneratorSingle(benchmark::State& state) {
+    WaveGeneratorTestPeer peer(kSampleRate, 697, 1209, 0.5f);
+    std::vector<int16_t> buffer(kFrameCount);
+    peer.getSamples(buffer.data(), 0, WaveGeneratorTestPeer::START);
+    for (auto _ : state) {
+        peer.getSamples(buffer.data(), kFrameCount, WaveGeneratorTestPeer::CONT);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kFrameCount);
+}
+BENCHMARK(BM_WaveGeneratorSingle);
+
+// The same with both waves in one pass, as ToneGenerator renders dual tones.
+void BM_WaveGeneratorPaired(benchmark::State& state) {
+    WaveGeneratorTestPeer peer(kSampleRate, 697, 1209, 0.5f);
+    std::vector<int16_t> buffer(kFrameCount);
+    peer.getSamplesPaired(buffer.data(), 0, WaveGeneratorTestPeer::START);
+    for (auto _ : state) {
+        peer.getSamplesPaired(buffer.data(), kFrameCount, WaveGeneratorTestPeer::CONT);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kFrameCount);
+}
+BENCHMARK(BM_WaveGeneratorPaired);
+
+}  // namespace
+
+BENCHMARK_MAIN();
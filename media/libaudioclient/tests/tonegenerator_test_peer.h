@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+
+#include <media/ToneGenerator.h>
+
+namespace android {
+
+// Runs the two sine waves of a tone either with one WaveGenerator::getSamples() call
+// each, or with the paired call ToneGenerator uses for dual tones.
+class WaveGeneratorTestPeer {
+public:
+    enum Command : unsigned int {
+        START = ToneGenerator::WaveGenerator::WAVEGEN_START,
+        CONT = ToneGenerator::WaveGenerator::WAVEGEN_CONT,
+        STOP = ToneGenerator::WaveGenerator::WAVEGEN_STOP,
+    };
+
+    WaveGeneratorTestPeer(uint32_t sampleRate, uint16_t frequency1, uint16_t frequency2,
+            float volume)
+        : mGen1(std::make_unique<ToneGenerator::WaveGenerator>(sampleRate, frequency1, volume)),
+          mGen2(std::make_unique<ToneGenerator::WaveGenerator>(sampleRate, frequency2, volume)) {}
+
+    void getSamples(int16_t* buffer, unsigned int count, Command command) {
+        mGen1->getSamples(buffer, count, command);
+        mGen2->getSamples(buffer, count, command);
+    }
+
+    void getSamplesPaired(int16_t* buffer, unsigned int count, Command command) {
+        ToneGenerator::WaveGenerator::getSamples(
+                mGen1.get(), mGen2.get(), buffer, count, command);
+    }
+
+private:
+    std::unique_ptr<ToneGenerator::WaveGenerator> mGen1;
+    std::unique_ptr<ToneGenerator::WaveGenerator> mGen2;
+};
+
+}  // namespace android
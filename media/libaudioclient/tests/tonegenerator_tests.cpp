@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "tonegenerator_test_peer.h"
+
+using namespace android;
+
+namespace {
+
+using Command = WaveGeneratorTestPeer::Command;
+
+struct Segment {
+    unsigned int count;
+    Command command;
+};
+
+// Starts, continues in segments of uneven sizes, ramps down, then restarts the wave,
+// as ToneGenerator does across callbacks and tone segments.
+const std::vector<Segment> kSegments = {
+        {160, Command::START}, {1, Command::CONT},   {333, Command::CONT},
+        {1024, Command::CONT}, {0, Command::STOP},   {97, Command::STOP},
+        {480, Command::START}, {479, Command::CONT}, {480, Command::STOP},
+};
+
+// sample rate, first frequency, second frequency, volume
+using PairedWaveParams = std::tuple<uint32_t, uint16_t, uint16_t, float>;
+
+class PairedWaveGeneratorTest : public ::testing::TestWithParam<PairedWaveParams> {};
+
+// The paired getSamples() must accumulate exactly what two single calls do.
+TEST_P(PairedWaveGeneratorTest, MatchesSingleGenerators) {
+    const auto [sampleRate, frequency1, frequency2, volume] = GetParam();
+    WaveGeneratorTestPeer single(sampleRate, frequency1, frequency2, volume);
+    WaveGeneratorTestPeer paired(sampleRate, frequency1, frequency2, volume);
+
+    for (const Segment& segment : kSegments) {
+        // Start from non zero content, the generators add to the buffer.
+        std::vector<int16_t> expected(segment.count);
+        for (size_t i = 0; i < expected.size(); i++) {
+            expected[i] = (int16_t)(i * 1021);
+        }
+        std::vector<int16_t> actual = expected;
+
+        single.getSamples(expected.data(), segment.count, segment.command);
+        paired.getSamplesPaired(actual.data(), segment.count, segment.command);
+        ASSERT_EQ(expected, actual)
+                << "count " << segment.count << " command " << segment.command;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        ToneGenerator, PairedWaveGeneratorTest,
+        ::testing::Values(
+                // DTMF 1 and D, call progress tones, and equal frequencies.
+                PairedWaveParams{8000, 697, 1209, 0.5f},
+                PairedWaveParams{16000, 941, 1633, 0.5f},
+                PairedWaveParams{44100, 350, 440, 1.0f},
+                PairedWaveParams{48000, 480, 620, 0.1f},
+                PairedWaveParams{48000, 1000, 1000, 1.0f}));
+
+}  // namespace
@@ -37,6 +37,32 @@ static inline bool isZero(float f) {
     return fabs(f) <= EPSILON;
 }
 
+// Complex bins are stored as interleaved (re, im) floats. Scaling both parts by a real
+// gain through the float view keeps these loops trivially vectorizable.
+static inline void applyBinGains(std::complex<float> *bins, const float *gains, size_t count) {
+    float *p = reinterpret_cast<float *>(bins);
+    for (size_t k = 0; k < count; k++) {
+        p[2 * k] *= gains[k];
+        p[2 * k + 1] *= gains[k];
+    }
+}
+
+static inline void applyBinGain(std::complex<float> *bins, float gain, size_t count) {
+    float *p = reinterpret_cast<float *>(bins);
+    for (size_t k = 0; k < 2 * count; k++) {
+        p[k] *= gain;
+    }
+}
+
+static inline float binEnergy(const std::complex<float> *bins, size_t count) {
+    const float *p = reinterpret_cast<const float *>(bins);
+    float energy = 0;
+    for (size_t k = 0; k < 2 * count; k++) {
+        energy += p[k] * p[k];
+    }
+    return energy;
+}
+
 template <class T>
 bool compareEquality(T a, T b) {
     return (a == b);
@@ -67,6 +93,9 @@ void ChannelBuffer::initBuffers(unsigned int blockSize, unsigned int overlapSize
     output.resize(mBlockSize);
     outTail.resize(overlapSize);
 
+    //half spectrum, including Nyquist bin
+    complexTemp.resize(halfFftSize);
+
     //module vectors
     mPreEqFactorVector.resize(halfFftSize, 1.0);
     mPostEqFactorVector.resize(halfFftSize, 1.0);
@@ -152,6 +181,10 @@ void DPFrequency::configure(size_t blockSize, size_t overlapSize,
     mHalfFFTSize = 1 + mBlockSize / 2; //including Nyquist bin
     mOverlapSize = std::min(overlapSize, mBlockSize/2);
 
+    //The input is real: only compute and keep the non-negative frequencies. The inverse
+    //transform only reads those bins anyway.
+    mFftServer.SetFlag(Eigen::FFT<float>::HalfSpectrum);
+
     int channelcount = getChannelCount();
     mSamplingRate = samplingRate;
     mChannelBuffers.resize(channelcount);
@@ -488,34 +521,33 @@ size_t DPFrequency::processFirstStages(ChannelBuffer &cb) {
     // TODO: optimize by using the noscale option, and compensate with dB scale offsets
     mFftServer.fwd(cb.complexTemp, eWin);
 
-    size_t cSize = cb.complexTemp.size();
-    size_t maxBin = std::min(cSize/2, mHalfFFTSize);
+    //gains are applied up to, but not including, the Nyquist bin
+    const size_t maxBin = mHalfFFTSize - 1;
 
     //== EqPre (always runs)
-    for (size_t k = 0; k < maxBin; k++) {
-        cb.complexTemp[k] *= cb.mPreEqFactorVector[k];
-    }
+    applyBinGains(cb.complexTemp.data(), cb.mPreEqFactorVector.data(), maxBin);
 
     //== MBC
     if (cb.mMbcInUse && cb.mMbcEnabled) {
         for (size_t band = 0; band < cb.mMbcBands.size(); band++) {
             ChannelBuffer::MbcBandParams *pMbcBandParams = &cb.mMbcBands[band];
-            float fEnergySum = 0;
+            //only the half spectrum is kept, so bands above Nyquist are clipped to it
+            const size_t binStart = pMbcBandParams->binStart;
+            const size_t binStop = std::min(pMbcBandParams->binStop + 1, mHalfFFTSize);
+            const size_t binCount = binStart < binStop ? binStop - binStart : 0;
+            std::complex<float> *pBandBins = cb.complexTemp.data() + binStart;
 
             //apply pre gain.
             float preGainFactor = dBtoLinear(pMbcBandParams->gainPreDb);
             float preGainSquared = preGainFactor * preGainFactor;
 
-            for (size_t k = pMbcBandParams->binStart; k <= pMbcBandParams->binStop; k++) {
-                fEnergySum += std::norm(cb.complexTemp[k]) * preGainSquared; //mag squared
-            }
+            //mag squared
+            float fEnergySum = binEnergy(pBandBins, binCount) * preGainSquared;
 
-            //Eigen FFT is full spectrum, even if the source was real data.
-            // Each half spectrum has half the energy. This is taken into account with the * 2
-            // factor in the energy computations.
+            //Only the half spectrum is computed. For real data the other half mirrors it
+            // and holds the same energy, which the * 2 factor accounts for.
             // energy = sqrt(sum_components_squared) number_points
-            // in here, the fEnergySum is duplicated to account for the second half spectrum,
-            // and the windowRms is used to normalize by the expected energy reduction
+            // in here, the windowRms is used to normalize by the expected energy reduction
             // caused by the window used (expected for steady state signals)
             fEnergySum = sqrt(fEnergySum * 2) / (mBlockSize * mWindowRms);
 
@@ -567,9 +599,7 @@ size_t DPFrequency::processFirstStages(ChannelBuffer &cb) {
             newFactor *= dBtoLinear(pMbcBandParams->gainPostDb);
 
             //apply to this band
-            for (size_t k = pMbcBandParams->binStart; k <= pMbcBandParams->binStop; k++) {
-                cb.complexTemp[k] *= newFactor;
-            }
+            applyBinGain(pBandBins, newFactor, binCount);
 
         } //end per band process
 
@@ -577,17 +607,12 @@ size_t DPFrequency::processFirstStages(ChannelBuffer &cb) {
 
     //== EqPost
     if (cb.mPostEqInUse && cb.mPostEqEnabled) {
-        for (size_t k = 0; k < maxBin; k++) {
-            cb.complexTemp[k] *= cb.mPostEqFactorVector[k];
-        }
+        applyBinGains(cb.complexTemp.data(), cb.mPostEqFactorVector.data(), maxBin);
     }
 
     //== Limiter. First Pass
     if (cb.mLimiterInUse && cb.mLimiterEnabled) {
-        float fEnergySum = 0;
-        for (size_t k = 0; k < maxBin; k++) {
-            fEnergySum += std::norm(cb.complexTemp[k]);
-        }
+        float fEnergySum = binEnergy(cb.complexTemp.data(), maxBin);
 
         //see explanation above for energy computation logic
         fEnergySum = sqrt(fEnergySum * 2) / (mBlockSize * mWindowRms);
@@ -656,11 +681,7 @@ size_t DPFrequency::processLastStages(ChannelBuffer &cb) {
 
     //apply to all if != 1.0
     if (!compareEquality(outputGainFactor, 1.0f)) {
-        size_t cSize = cb.complexTemp.size();
-        size_t maxBin = std::min(cSize/2, mHalfFFTSize);
-        for (size_t k = 0; k < maxBin; k++) {
-            cb.complexTemp[k] *= outputGainFactor;
-        }
+        applyBinGain(cb.complexTemp.data(), outputGainFactor, mHalfFFTSize - 1);
     }
 
     //##ifft directly to output.
@@ -115,14 +115,14 @@ LVDBE_ReturnStatus_en LVDBE_Process(
     if ((pInstance->Params.OperatingMode == LVDBE_ON) ||
         (LVC_Mixer_GetCurrent(&pInstance->pData->BypassMixer.MixerStream[0]) !=
          LVC_Mixer_GetTarget(&pInstance->pData->BypassMixer.MixerStream[0]))) {
-        // make copy of input data
-        Copy_Float(pInData, pScratch, (LVM_INT16)NrSamples);
-
         /*
-         * Apply the high pass filter if selected
+         * Apply the high pass filter if selected, filtering straight from the input
+         * into the scratch buffer, otherwise make copy of input data
          */
         if (pInstance->Params.HPFSelect == LVDBE_HPF_ON) {
-            pInstance->pHPFBiquad->process(pScratch, pScratch, NrFrames);
+            pInstance->pHPFBiquad->process(pScratch, pInData, NrFrames);
+        } else {
+            Copy_Float(pInData, pScratch, (LVM_INT16)NrSamples);
         }
 
         /*
@@ -27,27 +27,20 @@
 ***********************************************************************************/
 void Core_MixHard_2St_D32C31_SAT(Mix_2St_Cll_FLOAT_t* pInstance, const LVM_FLOAT* src1,
                                  const LVM_FLOAT* src2, LVM_FLOAT* dst, LVM_INT16 n) {
-    LVM_FLOAT Temp1, Temp2, Temp3;
     LVM_INT16 ii;
-    LVM_FLOAT Current1Short;
-    LVM_FLOAT Current2Short;
+    const LVM_FLOAT Current1Short = pInstance->Current1;
+    const LVM_FLOAT Current2Short = pInstance->Current2;
 
-    Current1Short = (pInstance->Current1);
-    Current2Short = (pInstance->Current2);
-
-    for (ii = n; ii != 0; ii--) {
-        Temp1 = *src1++;
-        Temp3 = Temp1 * Current1Short;
-        Temp2 = *src2++;
-        Temp1 = Temp2 * Current2Short;
-        Temp2 = (Temp1 / 2.0f) + (Temp3 / 2.0f);
-        if (Temp2 > 0.5f)
-            Temp2 = 1.0f;
-        else if (Temp2 < -0.5f)
-            Temp2 = -1.0f;
-        else
-            Temp2 = (Temp2 * 2);
-        *dst++ = Temp2;
+    for (ii = 0; ii < n; ii++) {
+        LVM_FLOAT Temp1 = src1[ii] * Current1Short;
+        LVM_FLOAT Temp2 = src2[ii] * Current2Short;
+        LVM_FLOAT Temp3 = (Temp2 / 2.0f) + (Temp1 / 2.0f);
+        /* Saturate at +/-0.5 with selects rather than branches, NaN still passes through.
+           Doubling unconditionally lets the compiler do so without speculating it. */
+        LVM_FLOAT Out = Temp3 * 2;
+        Out = (Temp3 > 0.5f) ? 1.0f : Out;
+        Out = (Temp3 < -0.5f) ? -1.0f : Out;
+        dst[ii] = Out;
     }
 }
 /**********************************************************************************/
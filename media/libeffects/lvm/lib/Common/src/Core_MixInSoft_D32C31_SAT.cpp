@@ -28,45 +28,49 @@
 
 void Core_MixInSoft_D32C31_SAT(Mix_1St_Cll_FLOAT_t* pInstance, const LVM_FLOAT* src, LVM_FLOAT* dst,
                                LVM_INT16 n) {
-    LVM_FLOAT Temp1, Temp2, Temp3;
     LVM_INT16 OutLoop;
     LVM_INT16 InLoop;
     LVM_FLOAT TargetTimesOneMinAlpha;
     LVM_FLOAT CurrentTimesAlpha;
     LVM_INT16 ii, jj;
 
+    /* Keep the gain in a local: dst may alias pInstance, which would otherwise force
+       a reload after every store and prevent the 4 sample body from being vectorized */
+    const LVM_FLOAT Alpha = pInstance->Alpha;
+    LVM_FLOAT Current = pInstance->Current;
+
     InLoop = (LVM_INT16)(n >> 2); /* Process per 4 samples */
     OutLoop = (LVM_INT16)(n - (InLoop << 2));
 
-    TargetTimesOneMinAlpha = ((1.0f - pInstance->Alpha) * pInstance->Target);
-    if (pInstance->Target >= pInstance->Current) {
+    TargetTimesOneMinAlpha = ((1.0f - Alpha) * pInstance->Target);
+    if (pInstance->Target >= Current) {
         TargetTimesOneMinAlpha += (LVM_FLOAT)(2.0f / 2147483647.0f); /* Ceil*/
     }
 
     if (OutLoop) {
-        CurrentTimesAlpha = pInstance->Current * pInstance->Alpha;
-        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
+        CurrentTimesAlpha = Current * Alpha;
+        Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
 
         for (ii = OutLoop; ii != 0; ii--) {
-            Temp1 = *src++;
-            Temp2 = *dst;
-
-            Temp3 = Temp1 * (pInstance->Current);
-            *dst++ = LVM_Clamp(Temp2 + Temp3);
+            LVM_FLOAT Temp = *src++ * Current;
+            *dst = LVM_Clamp(*dst + Temp);
+            dst++;
         }
     }
 
     for (ii = InLoop; ii != 0; ii--) {
-        CurrentTimesAlpha = pInstance->Current * pInstance->Alpha;
-        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
+        CurrentTimesAlpha = Current * Alpha;
+        Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
 
-        for (jj = 4; jj != 0; jj--) {
-            Temp1 = *src++;
-            Temp2 = *dst;
-
-            Temp3 = Temp1 * (pInstance->Current);
-            *dst++ = LVM_Clamp(Temp2 + Temp3);
+        /* All 4 samples share one gain: independent lanes */
+        for (jj = 0; jj < 4; jj++) {
+            LVM_FLOAT Temp = src[jj] * Current;
+            dst[jj] = LVM_Clamp(dst[jj] + Temp);
         }
+        src += 4;
+        dst += 4;
     }
+
+    pInstance->Current = Current;
 }
 /**********************************************************************************/
@@ -27,67 +27,44 @@
 ***********************************************************************************/
 void Core_MixSoft_1St_D32C31_WRA(Mix_1St_Cll_FLOAT_t* pInstance, const LVM_FLOAT* src,
                                  LVM_FLOAT* dst, LVM_INT16 n) {
-    LVM_FLOAT Temp1, Temp2;
     LVM_INT16 OutLoop;
     LVM_INT16 InLoop;
     LVM_FLOAT TargetTimesOneMinAlpha;
     LVM_FLOAT CurrentTimesAlpha;
+    LVM_INT16 ii, jj;
 
-    LVM_INT16 ii;
+    /* Local copy of the gain, see Core_MixInSoft_D32C31_SAT */
+    const LVM_FLOAT Alpha = pInstance->Alpha;
+    LVM_FLOAT Current = pInstance->Current;
 
     InLoop = (LVM_INT16)(n >> 2); /* Process per 4 samples */
     OutLoop = (LVM_INT16)(n - (InLoop << 2));
 
-    TargetTimesOneMinAlpha =
-            (1.0f - pInstance->Alpha) * pInstance->Target; /* float * float in float */
-    if (pInstance->Target >= pInstance->Current) {
+    TargetTimesOneMinAlpha = (1.0f - Alpha) * pInstance->Target; /* float * float in float */
+    if (pInstance->Target >= Current) {
         TargetTimesOneMinAlpha += (LVM_FLOAT)(2.0f / 2147483647.0f); /* Ceil*/
     }
 
     if (OutLoop != 0) {
-        CurrentTimesAlpha = (pInstance->Current * pInstance->Alpha);
-        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
+        CurrentTimesAlpha = Current * Alpha;
+        Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
 
         for (ii = OutLoop; ii != 0; ii--) {
-            Temp1 = *src;
-            src++;
-
-            Temp2 = Temp1 * (pInstance->Current);
-            *dst = Temp2;
-            dst++;
+            *dst++ = *src++ * Current;
         }
     }
 
     for (ii = InLoop; ii != 0; ii--) {
-        CurrentTimesAlpha = pInstance->Current * pInstance->Alpha;
-        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
-
-        Temp1 = *src;
-        src++;
-
-        Temp2 = Temp1 * (pInstance->Current);
-        *dst = Temp2;
-        dst++;
-
-        Temp1 = *src;
-        src++;
-
-        Temp2 = Temp1 * (pInstance->Current);
-        *dst = Temp2;
-        dst++;
+        CurrentTimesAlpha = Current * Alpha;
+        Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
 
-        Temp1 = *src;
-        src++;
-
-        Temp2 = Temp1 * (pInstance->Current);
-        *dst = Temp2;
-        dst++;
-
-        Temp1 = *src;
-        src++;
-        Temp2 = Temp1 * (pInstance->Current);
-        *dst = Temp2;
-        dst++;
+        for (jj = 0; jj < 4; jj++) {
+            dst[jj] = src[jj] * Current;
+        }
+        src += 4;
+        dst += 4;
     }
+
+    pInstance->Current = Current;
 }
 /**********************************************************************************/
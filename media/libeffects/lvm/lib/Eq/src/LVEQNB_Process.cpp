@@ -86,11 +86,18 @@ LVEQNB_ReturnStatus_en LVEQNB_Process(
 
     if (pInstance->Params.OperatingMode == LVEQNB_ON) {
         /*
-         * Copy input data in to scratch buffer
+         * The bands are accumulated in place. The dry input is only needed again for the
+         * bypass cross fade, so outside of a transition work directly in the output buffer
+         * and save two full copies of all channel samples per call.
          */
-        Copy_Float(pInData,  /* Source */
-                   pScratch, /* Destination */
-                   (LVM_INT16)NrSamples);
+        const LVM_INT16 bTransition = (pInstance->bInOperatingModeTransition == LVM_TRUE);
+        LVM_FLOAT* const pAccumulator = bTransition ? pScratch : pOutData;
+
+        if (pInData != pAccumulator) {
+            Copy_Float(pInData,      /* Source */
+                       pAccumulator, /* Destination */
+                       (LVM_INT16)NrSamples);
+        }
 
         /*
          * For each section execte the filter unless the gain is 0dB
@@ -107,10 +114,10 @@ LVEQNB_ReturnStatus_en LVEQNB_Process(
                     switch (pInstance->pBiquadType[i]) {
                         case LVEQNB_SinglePrecision_Float: {
                             LVM_FLOAT* pTemp = pScratch + NrSamples;
-                            pInstance->eqBiquad[i].process(pTemp, pScratch, NrFrames);
+                            pInstance->eqBiquad[i].process(pTemp, pAccumulator, NrFrames);
                             const auto gain = pInstance->gain[i];
                             for (unsigned j = 0; j < NrSamples; ++j) {
-                                pScratch[j] += pTemp[j] * gain;
+                                pAccumulator[j] += pTemp[j] * gain;
                             }
                             break;
                         }
@@ -121,17 +128,17 @@ LVEQNB_ReturnStatus_en LVEQNB_Process(
             }
         }
 
-        if (pInstance->bInOperatingModeTransition == LVM_TRUE) {
-            LVC_MixSoft_2Mc_D16C31_SAT(&pInstance->BypassMixer, pScratch, pInData, pScratch,
+        if (bTransition) {
+            /* The mixer writes dst before reading src2, so it cannot mix in place over the
+               dry input */
+            LVM_FLOAT* const pMixed = (pInData != pOutData) ? pOutData : pScratch;
+            LVC_MixSoft_2Mc_D16C31_SAT(&pInstance->BypassMixer, pScratch, pInData, pMixed,
                                        (LVM_INT16)NrFrames, (LVM_INT16)NrChannels);
-            // duplicate with else clause(s)
-            Copy_Float(pScratch,              /* Source */
-                       pOutData,              /* Destination */
-                       (LVM_INT16)NrSamples); /* All channel samples */
-        } else {
-            Copy_Float(pScratch,              /* Source */
-                       pOutData,              /* Destination */
-                       (LVM_INT16)NrSamples); /* All channel samples */
+            if (pMixed != pOutData) {
+                Copy_Float(pMixed,                /* Source */
+                           pOutData,              /* Destination */
+                           (LVM_INT16)NrSamples); /* All channel samples */
+            }
         }
     } else {
         /*
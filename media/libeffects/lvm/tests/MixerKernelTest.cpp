@@ -0,0 +1,283 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Mixer.h"
+#include "ScalarArithmetic.h"
+
+// The mixer cores as they were before they were made vectorizable, kept to check that
+// the current ones still give bit-exact results.
+namespace reference {
+
+void Core_MixHard_2St_D32C31_SAT(Mix_2St_Cll_FLOAT_t* pInstance, const LVM_FLOAT* src1,
+                                 const LVM_FLOAT* src2, LVM_FLOAT* dst, LVM_INT16 n) {
+    LVM_FLOAT Temp1, Temp2, Temp3;
+    LVM_INT16 ii;
+    LVM_FLOAT Current1Short;
+    LVM_FLOAT Current2Short;
+
+    Current1Short = (pInstance->Current1);
+    Current2Short = (pInstance->Current2);
+
+    for (ii = n; ii != 0; ii--) {
+        Temp1 = *src1++;
+        Temp3 = Temp1 * Current1Short;
+        Temp2 = *src2++;
+        Temp1 = Temp2 * Current2Short;
+        Temp2 = (Temp1 / 2.0f) + (Temp3 / 2.0f);
+        if (Temp2 > 0.5f)
+            Temp2 = 1.0f;
+        else if (Temp2 < -0.5f)
+            Temp2 = -1.0f;
+        else
+            Temp2 = (Temp2 * 2);
+        *dst++ = Temp2;
+    }
+}
+
+void Core_MixInSoft_D32C31_SAT(Mix_1St_Cll_FLOAT_t* pInstance, const LVM_FLOAT* src, LVM_FLOAT* dst,
+                               LVM_INT16 n) {
+    LVM_FLOAT Temp1, Temp2, Temp3;
+    LVM_INT16 OutLoop;
+    LVM_INT16 InLoop;
+    LVM_FLOAT TargetTimesOneMinAlpha;
+    LVM_FLOAT CurrentTimesAlpha;
+    LVM_INT16 ii, jj;
+
+    InLoop = (LVM_INT16)(n >> 2); /* Process per 4 samples */
+    OutLoop = (LVM_INT16)(n - (InLoop << 2));
+
+    TargetTimesOneMinAlpha = ((1.0f - pInstance->Alpha) * pInstance->Target);
+    if (pInstance->Target >= pInstance->Current) {
+        TargetTimesOneMinAlpha += (LVM_FLOAT)(2.0f / 2147483647.0f); /* Ceil*/
+    }
+
+    if (OutLoop) {
+        CurrentTimesAlpha = pInstance->Current * pInstance->Alpha;
+        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
+
+        for (ii = OutLoop; ii != 0; ii--) {
+            Temp1 = *src++;
+            Temp2 = *dst;
+
+            Temp3 = Temp1 * (pInstance->Current);
+            *dst++ = LVM_Clamp(Temp2 + Temp3);
+        }
+    }
+
+    for (ii = InLoop; ii != 0; ii--) {
+        CurrentTimesAlpha = pInstance->Current * pInstance->Alpha;
+        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
+
+        for (jj = 4; jj != 0; jj--) {
+            Temp1 = *src++;
+            Temp2 = *dst;
+
+            Temp3 = Temp1 * (pInstance->Current);
+            *dst++ = LVM_Clamp(Temp2 + Temp3);
+        }
+    }
+}
+
+void Core_MixSoft_1St_D32C31_WRA(Mix_1St_Cll_FLOAT_t* pInstance, const LVM_FLOAT* src,
+                                 LVM_FLOAT* dst, LVM_INT16 n) {
+    LVM_FLOAT Temp1, Temp2;
+    LVM_INT16 OutLoop;
+    LVM_INT16 InLoop;
+    LVM_FLOAT TargetTimesOneMinAlpha;
+    LVM_FLOAT CurrentTimesAlpha;
+
+    LVM_INT16 ii;
+
+    InLoop = (LVM_INT16)(n >> 2); /* Process per 4 samples */
+    OutLoop = (LVM_INT16)(n - (InLoop << 2));
+
+    TargetTimesOneMinAlpha =
+            (1.0f - pInstance->Alpha) * pInstance->Target; /* float * float in float */
+    if (pInstance->Target >= pInstance->Current) {
+        TargetTimesOneMinAlpha += (LVM_FLOAT)(2.0f / 2147483647.0f); /* Ceil*/
+    }
+
+    if (OutLoop != 0) {
+        CurrentTimesAlpha = (pInstance->Current * pInstance->Alpha);
+        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
+
+        for (ii = OutLoop; ii != 0; ii--) {
+            Temp1 = *src;
+            src++;
+
+            Temp2 = Temp1 * (pInstance->Current);
+            *dst = Temp2;
+            dst++;
+        }
+    }
+
+    for (ii = InLoop; ii != 0; ii--) {
+        CurrentTimesAlpha = pInstance->Current * pInstance->Alpha;
+        pInstance->Current = TargetTimesOneMinAlpha + CurrentTimesAlpha;
+
+        Temp1 = *src;
+        src++;
+
+        Temp2 = Temp1 * (pInstance->Current);
+        *dst = Temp2;
+        dst++;
+
+        Temp1 = *src;
+        src++;
+
+        Temp2 = Temp1 * (pInstance->Current);
+        *dst = Temp2;
+        dst++;
+
+        Temp1 = *src;
+        src++;
+
+        Temp2 = Temp1 * (pInstance->Current);
+        *dst = Temp2;
+        dst++;
+
+        Temp1 = *src;
+        src++;
+        Temp2 = Temp1 * (pInstance->Current);
+        *dst = Temp2;
+        dst++;
+    }
+}
+
+}  // namespace reference
+
+constexpr int kNumRuns = 200;
+constexpr LVM_INT16 kMaxSamples = 259;
+
+class MixerKernelTest : public ::testing::Test {
+  protected:
+    // Mostly in range samples, with some that saturate and a few non finite ones.
+    std::vector<LVM_FLOAT> randomSamples(size_t count) {
+        std::uniform_real_distribution<LVM_FLOAT> sample(-2.0f, 2.0f);
+        std::uniform_int_distribution<int> special(0, 99);
+        std::vector<LVM_FLOAT> samples(count);
+        for (LVM_FLOAT& s : samples) {
+            switch (special(mRng)) {
+                case 0:
+                    s = std::numeric_limits<LVM_FLOAT>::infinity();
+                    break;
+                case 1:
+                    s = -std::numeric_limits<LVM_FLOAT>::infinity();
+                    break;
+                case 2:
+                    s = std::numeric_limits<LVM_FLOAT>::quiet_NaN();
+                    break;
+                default:
+                    s = sample(mRng);
+                    break;
+            }
+        }
+        return samples;
+    }
+
+    LVM_FLOAT randomGain() { return std::uniform_real_distribution<LVM_FLOAT>(0.0f, 2.0f)(mRng); }
+
+    LVM_FLOAT randomAlpha() {
+        return std::uniform_real_distribution<LVM_FLOAT>(0.9f, 1.0f)(mRng);
+    }
+
+    LVM_INT16 randomCount() {
+        return std::uniform_int_distribution<LVM_INT16>(0, kMaxSamples)(mRng);
+    }
+
+    static bool bitExact(const std::vector<LVM_FLOAT>& a, const std::vector<LVM_FLOAT>& b) {
+        return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0;
+    }
+
+    static bool bitExact(LVM_FLOAT a, LVM_FLOAT b) { return memcmp(&a, &b, sizeof(a)) == 0; }
+
+    std::mt19937 mRng{42};
+};
+
+TEST_F(MixerKernelTest, MixHard2StMatchesReference) {
+    for (int run = 0; run < kNumRuns; ++run) {
+        const LVM_INT16 n = randomCount();
+        const std::vector<LVM_FLOAT> src1 = randomSamples(n);
+        const std::vector<LVM_FLOAT> src2 = randomSamples(n);
+        Mix_2St_Cll_FLOAT_t instance{};
+        instance.Current1 = randomGain();
+        instance.Current2 = randomGain();
+        Mix_2St_Cll_FLOAT_t expectedInstance = instance;
+
+        std::vector<LVM_FLOAT> dst(n), expected(n);
+        Core_MixHard_2St_D32C31_SAT(&instance, src1.data(), src2.data(), dst.data(), n);
+        reference::Core_MixHard_2St_D32C31_SAT(&expectedInstance, src1.data(), src2.data(),
+                                               expected.data(), n);
+        EXPECT_TRUE(bitExact(expected, dst)) << "run " << run << " n " << n;
+
+        // in place, as the callers mix into their first stream
+        std::vector<LVM_FLOAT> inPlace(src1);
+        Core_MixHard_2St_D32C31_SAT(&instance, inPlace.data(), src2.data(), inPlace.data(), n);
+        EXPECT_TRUE(bitExact(expected, inPlace)) << "run " << run << " n " << n;
+    }
+}
+
+TEST_F(MixerKernelTest, MixInSoftMatchesReference) {
+    for (int run = 0; run < kNumRuns; ++run) {
+        const LVM_INT16 n = randomCount();
+        const std::vector<LVM_FLOAT> src = randomSamples(n);
+        const std::vector<LVM_FLOAT> initialDst = randomSamples(n);
+        Mix_1St_Cll_FLOAT_t instance{};
+        instance.Alpha = randomAlpha();
+        instance.Target = randomGain();
+        instance.Current = randomGain();
+        Mix_1St_Cll_FLOAT_t expectedInstance = instance;
+
+        std::vector<LVM_FLOAT> dst(initialDst), expected(initialDst);
+        Core_MixInSoft_D32C31_SAT(&instance, src.data(), dst.data(), n);
+        reference::Core_MixInSoft_D32C31_SAT(&expectedInstance, src.data(), expected.data(), n);
+        EXPECT_TRUE(bitExact(expected, dst)) << "run " << run << " n " << n;
+        EXPECT_TRUE(bitExact(expectedInstance.Current, instance.Current))
+                << "run " << run << " n " << n;
+    }
+}
+
+TEST_F(MixerKernelTest, MixSoft1StMatchesReference) {
+    for (int run = 0; run < kNumRuns; ++run) {
+        const LVM_INT16 n = randomCount();
+        const std::vector<LVM_FLOAT> src = randomSamples(n);
+        Mix_1St_Cll_FLOAT_t instance{};
+        instance.Alpha = randomAlpha();
+        instance.Target = randomGain();
+        instance.Current = randomGain();
+        Mix_1St_Cll_FLOAT_t expectedInstance = instance;
+        Mix_1St_Cll_FLOAT_t inPlaceInstance = instance;
+
+        std::vector<LVM_FLOAT> dst(n), expected(n);
+        Core_MixSoft_1St_D32C31_WRA(&instance, src.data(), dst.data(), n);
+        reference::Core_MixSoft_1St_D32C31_WRA(&expectedInstance, src.data(), expected.data(), n);
+        EXPECT_TRUE(bitExact(expected, dst)) << "run " << run << " n " << n;
+        EXPECT_TRUE(bitExact(expectedInstance.Current, instance.Current))
+                << "run " << run << " n " << n;
+
+        std::vector<LVM_FLOAT> inPlace(src);
+        Core_MixSoft_1St_D32C31_WRA(&inPlaceInstance, inPlace.data(), inPlace.data(), n);
+        EXPECT_TRUE(bitExact(expected, inPlace)) << "run " << run << " n " << n;
+    }
+}
@@ -3049,7 +3049,7 @@ int Effect_process(effect_handle_t self, audio_buffer_t* inBuffer, audio_buffer_
             }
         } else if (outBuffer->raw != inBuffer->raw) {
             memcpy(outBuffer->raw, inBuffer->raw,
-                   outBuffer->frameCount * sizeof(effect_buffer_t) * FCC_2);
+                   outBuffer->frameCount * sizeof(effect_buffer_t) * NrChannels);
         }
     }
 
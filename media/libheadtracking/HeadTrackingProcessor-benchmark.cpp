@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media/HeadTrackingProcessor.h"
+#include "media/QuaternionUtil.h"
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace android::media;
+
+namespace {
+
+constexpr int64_t kTicksPerSecond = 1'000'000'000;
+
+// The pose controller recalculates at a fixed rate, independently of the sensor rate.
+constexpr int64_t kCalculatePeriod = kTicksPerSecond / 50;
+
+// Options similar to the ones used by SpatializerPoseController.
+std::unique_ptr<HeadTrackingProcessor> createProcessor() {
+    std::unique_ptr<HeadTrackingProcessor> processor = createHeadTrackingProcessor(
+            HeadTrackingProcessor::Options{
+                    .maxTranslationalVelocity = 2.f / kTicksPerSecond,
+                    .maxRotationalVelocity = 0.8f / kTicksPerSecond,
+                    .freshnessTimeout = kTicksPerSecond / 8,
+                    .predictionDuration = kTicksPerSecond / 8,
+                    .autoRecenterWindowDuration = 6 * kTicksPerSecond,
+                    .autoRecenterTranslationalThreshold = 0.1f,
+                    .autoRecenterRotationalThreshold = 10.5f / 180 * M_PI,
+                    .screenStillnessWindowDuration = kTicksPerSecond * 3 / 4,
+                    .screenStillnessTranslationalThreshold = 0.1f,
+                    .screenStillnessRotationalThreshold = 15.f / 180 * M_PI,
+            },
+            HeadTrackingMode::SCREEN_RELATIVE);
+    processor->setWorldToScreenPose(0, Pose3f());
+    return processor;
+}
+
+// A slowly turning head, so that the stillness window stays populated.
+HeadTrackingProcessor::HeadPoseSample sampleAt(int64_t timestamp) {
+    const float seconds = (float) timestamp / kTicksPerSecond;
+    return {timestamp, Pose3f({0, 0, 0}, rotateZ(0.01f * seconds)),
+            Twist3f({0, 0, 0}, {0, 0, 0.01f / kTicksPerSecond})};
+}
+
+// Feeds one sample at a time, as the sensor callback does. Arg is the sensor rate in Hz.
+void BM_HeadTrackingProcessor_PerSample(benchmark::State& state) {
+    const int64_t samplePeriod = kTicksPerSecond / state.range(0);
+    std::unique_ptr<HeadTrackingProcessor> processor = createProcessor();
+    int64_t timestamp = 0;
+    int64_t nextCalculate = kCalculatePeriod;
+    for (auto _ : state) {
+        const HeadTrackingProcessor::HeadPoseSample sample = sampleAt(timestamp);
+        processor->setWorldToHeadPose(sample.timestamp, sample.worldToHead, sample.headTwist);
+        if (timestamp >= nextCalculate) {
+            processor->calculate(timestamp);
+            benchmark::DoNotOptimize(processor->getHeadToStagePose());
+            nextCalculate += kCalculatePeriod;
+        }
+        timestamp += samplePeriod;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Feeds the samples accumulated during one calculate period at once.
+// Arg is the sensor rate in Hz, each iteration processes one sample.
+void BM_HeadTrackingProcessor_Batch(benchmark::State& state) {
+    const int64_t samplePeriod = kTicksPerSecond / state.range(0);
+    std::unique_ptr<HeadTrackingProcessor> processor = createProcessor();
+    std::vector<HeadTrackingProcessor::HeadPoseSample> block;
+    block.reserve(kCalculatePeriod / samplePeriod + 1);
+    int64_t timestamp = 0;
+    int64_t nextCalculate = kCalculatePeriod;
+    for (auto _ : state) {
+        block.push_back(sampleAt(timestamp));
+        if (timestamp >= nextCalculate) {
+            processor->setWorldToHeadPoses(block.data(), block.size());
+            block.clear();
+            processor->calculate(timestamp);
+            benchmark::DoNotOptimize(processor->getHeadToStagePose());
+            nextCalculate += kCalculatePeriod;
+        }
+        timestamp += samplePeriod;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void SensorRateArgs(benchmark::internal::Benchmark* b) {
+    for (int rateHz : {100, 200, 400, 1000}) {
+        b->Arg(rateHz);
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_HeadTrackingProcessor_PerSample)->Apply(SensorRateArgs);
+BENCHMARK(BM_HeadTrackingProcessor_Batch)->Apply(SensorRateArgs);
+
+BENCHMARK_MAIN();
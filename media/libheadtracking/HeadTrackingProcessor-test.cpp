@@ -17,6 +17,8 @@
 #include "media/HeadTrackingProcessor.h"
 #include "media/QuaternionUtil.h"
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "TestUtil.h"
@@ -141,6 +143,39 @@ TEST(HeadTrackingProcessor, SmoothModeSwitch) {
     EXPECT_EQ(processor->getHeadToStagePose(), Pose3f());
 }
 
+TEST(HeadTrackingProcessor, BatchMatchesPerSample) {
+    const Options options{
+            .predictionDuration = 2.f,
+            .autoRecenterWindowDuration = 20,
+            .autoRecenterTranslationalThreshold = 0.1f,
+            .autoRecenterRotationalThreshold = 0.1f,
+    };
+    std::unique_ptr<HeadTrackingProcessor> perSample =
+            createHeadTrackingProcessor(options, HeadTrackingMode::WORLD_RELATIVE);
+    std::unique_ptr<HeadTrackingProcessor> batched =
+            createHeadTrackingProcessor(options, HeadTrackingMode::WORLD_RELATIVE);
+
+    constexpr size_t kBlockSize = 8;
+    std::vector<HeadTrackingProcessor::HeadPoseSample> block;
+    for (int64_t t = 0; t < 100; ++t) {
+        // Keep still for a while, then turn, so that auto-recentering kicks in along the way.
+        const float angle = t < 50 ? 0.f : (t - 50) * 0.05f;
+        const Pose3f worldToHead{{0, 0, 0}, rotateZ(angle)};
+        const Twist3f headTwist{{0, 0, 0}, {0, 0, t < 50 ? 0.f : 0.05f}};
+
+        perSample->setWorldToHeadPose(t, worldToHead, headTwist);
+        block.push_back({t, worldToHead, headTwist});
+        if (block.size() == kBlockSize) {
+            batched->setWorldToHeadPoses(block.data(), block.size());
+            block.clear();
+            perSample->calculate(t);
+            batched->calculate(t);
+            ASSERT_EQ(perSample->getActualMode(), batched->getActualMode());
+            EXPECT_EQ(perSample->getHeadToStagePose(), batched->getHeadToStagePose());
+        }
+    }
+}
+
 }  // namespace
 }  // namespace media
 }  // namespace android
@@ -67,6 +67,24 @@ class HeadTrackingProcessorImpl : public HeadTrackingProcessor {
         mWorldToHeadTimestamp = timestamp;
     }
 
+    void setWorldToHeadPoses(const HeadPoseSample* samples, size_t count) override {
+        if (count == 0) {
+            return;
+        }
+        // The predictor and the stillness detector keep a history, so they see every sample.
+        // The bias only keeps its most recent input.
+        Pose3f predictedWorldToHead;
+        for (size_t i = 0; i < count; ++i) {
+            const HeadPoseSample& sample = samples[i];
+            predictedWorldToHead = mPosePredictor.predict(
+                    sample.timestamp, sample.worldToHead, sample.headTwist,
+                    mOptions.predictionDuration);
+            mHeadStillnessDetector.setInput(sample.timestamp, predictedWorldToHead);
+        }
+        mHeadPoseBias.setInput(predictedWorldToHead);
+        mWorldToHeadTimestamp = samples[count - 1].timestamp;
+    }
+
     void setWorldToScreenPose(int64_t timestamp, const Pose3f& worldToScreen) override {
         if (mPhysicalToLogicalAngle != mPendingPhysicalToLogicalAngle) {
             // We're introducing an artificial discontinuity. Enable the rate limiter.
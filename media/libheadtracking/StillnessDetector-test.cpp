@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <deque>
+#include <random>
+
 #include <gtest/gtest.h>
 
 #include "StillnessDetector.h"
@@ -29,6 +32,69 @@ using Eigen::Quaternionf;
 using Eigen::Vector3f;
 using Options = StillnessDetector::Options;
 
+// Scans the whole window on every calculate(), as StillnessDetector did before it kept a bound on
+// the window. StillnessDetector must give the same results.
+class BruteForceStillnessDetector {
+  public:
+    explicit BruteForceStillnessDetector(const Options& options)
+        : mOptions(options), mCosHalfRotationalThreshold(cos(options.rotationalThreshold / 2)) {}
+
+    void setInput(int64_t timestamp, const Pose3f& input) {
+        mFifo.push_back(TimestampedPose{timestamp, input});
+        discardOld(timestamp);
+    }
+
+    bool calculate(int64_t timestamp) {
+        discardOld(timestamp);
+        bool moved = false;
+        if (!mFifo.empty()) {
+            for (auto iter = mFifo.rbegin() + 1; iter != mFifo.rend(); ++iter) {
+                if (!areNear(iter->pose, mFifo.back().pose)) {
+                    int64_t deadline = iter->timestamp + mOptions.windowDuration;
+                    if (!mSuppressionDeadline.has_value() || *mSuppressionDeadline < deadline) {
+                        mSuppressionDeadline = deadline;
+                    }
+                    moved = true;
+                    break;
+                }
+            }
+        }
+        if (!mWindowFull) {
+            return mOptions.defaultValue;
+        }
+        return !mSuppressionDeadline.has_value() && !moved;
+    }
+
+  private:
+    struct TimestampedPose {
+        int64_t timestamp;
+        Pose3f pose;
+    };
+
+    void discardOld(int64_t timestamp) {
+        const int64_t windowStart = timestamp - mOptions.windowDuration;
+        while (!mFifo.empty() && mFifo.front().timestamp <= windowStart) {
+            mWindowFull = true;
+            mFifo.pop_front();
+        }
+        if (mSuppressionDeadline.has_value() && *mSuppressionDeadline <= timestamp) {
+            mSuppressionDeadline.reset();
+        }
+    }
+
+    bool areNear(const Pose3f& pose1, const Pose3f& pose2) const {
+        return (pose1.translation() - pose2.translation()).lpNorm<1>()
+                       <= mOptions.translationalThreshold
+               && pose1.rotation().dot(pose2.rotation()) >= mCosHalfRotationalThreshold;
+    }
+
+    const Options mOptions;
+    const float mCosHalfRotationalThreshold;
+    std::deque<TimestampedPose> mFifo;
+    bool mWindowFull = false;
+    std::optional<int64_t> mSuppressionDeadline;
+};
+
 class StillnessDetectorTest : public testing::TestWithParam<bool> {
   public:
     void SetUp() override { mDefaultValue = GetParam(); }
@@ -160,6 +226,64 @@ TEST_P(StillnessDetectorTest, Reset) {
     EXPECT_TRUE(detector.calculate(1600));
 }
 
+TEST_P(StillnessDetectorTest, SlowDrift) {
+    StillnessDetector detector(Options{.defaultValue = mDefaultValue,
+                                       .windowDuration = 1000,
+                                       .translationalThreshold = 1,
+                                       .rotationalThreshold = 0.05});
+
+    // Each step is well within the threshold, but the drift accumulates to 0.02 radians over
+    // 200 ticks, and exceeds the threshold once the window spans more than 500 ticks of it.
+    const Pose3f baseline(Vector3f{1, 2, 3}, Quaternionf::UnitRandom());
+    for (int64_t t = 0; t <= 200; t += 10) {
+        detector.setInput(t, baseline);
+    }
+    EXPECT_EQ(mDefaultValue, detector.calculate(200));
+    for (int64_t t = 210; t <= 1300; t += 10) {
+        detector.setInput(t, baseline * Pose3f(rotateZ((t - 200) * 0.0001)));
+        const bool still = detector.calculate(t);
+        if (t < 1000) {
+            EXPECT_EQ(mDefaultValue, still) << "t=" << t;
+        } else {
+            EXPECT_FALSE(still) << "t=" << t;
+        }
+    }
+}
+
+TEST_P(StillnessDetectorTest, MatchesBruteForce) {
+    const Options options{.defaultValue = mDefaultValue,
+                          .windowDuration = 100,
+                          .translationalThreshold = 0.1,
+                          .rotationalThreshold = 0.05};
+    StillnessDetector detector(options);
+    BruteForceStillnessDetector bruteForce(options);
+
+    // A head that holds still with some jitter, and now and then moves to a new pose. Poses are
+    // composed in float, as the head tracking pipeline does, so their rotations drift off unit
+    // length. The drift is exaggerated here.
+    std::mt19937 rng(GetParam() ? 1 : 2);
+    std::normal_distribution<float> jitter(0, 0.005);
+    std::uniform_real_distribution<float> uniform(-1, 1);
+    Pose3f head(Vector3f{1, 2, 3}, Quaternionf::UnitRandom());
+    for (int64_t t = 0; t < 300000; ++t) {
+        if (rng() % 500 == 0) {
+            head = head * Pose3f(Vector3f(uniform(rng), uniform(rng), uniform(rng)) * 0.05f,
+                                 Quaternionf(Eigen::AngleAxisf(uniform(rng) * 0.1f,
+                                                               Vector3f::UnitZ())));
+        }
+        if (rng() % 100 == 0) {
+            head = Pose3f(head.translation(),
+                          Quaternionf(head.rotation().coeffs() * (1 + uniform(rng) * 1e-5f)));
+        }
+        const Vector3f axis = Vector3f(uniform(rng), uniform(rng), uniform(rng)).normalized();
+        const Pose3f pose = head * Pose3f(Vector3f(jitter(rng), jitter(rng), jitter(rng)),
+                                          Quaternionf(Eigen::AngleAxisf(jitter(rng), axis)));
+        detector.setInput(t, pose);
+        bruteForce.setInput(t, pose);
+        ASSERT_EQ(bruteForce.calculate(t), detector.calculate(t)) << "t=" << t;
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(StillnessDetectorTestParametrized, StillnessDetectorTest,
                          testing::Values(false, true));
 
@@ -16,23 +16,71 @@
 
 #include "StillnessDetector.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace android {
 namespace media {
+namespace {
+
+using Eigen::Quaternionf;
+
+// Only skip the scan if the bound stays this far below the thresholds, which leaves room for
+// rounding errors. The dot product margin covers the float rounding in areNear(), the half angle
+// slack the poor conditioning of acos() near 1.
+constexpr float kBoundMargin = 0.99f;
+constexpr double kDotMargin = 1e-6;
+constexpr float kHalfAngleSlack = 1e-6f;
+
+float translationalDistance(const Pose3f& pose1, const Pose3f& pose2) {
+    return (pose1.translation() - pose2.translation()).lpNorm<1>();
+}
+
+// Cosine of half the angle of the rotation between two quaternions. Composed poses drift off unit
+// length, so unlike their dot product this divides by their norms.
+double cosHalfAngleBetween(const Quaternionf& q1, const Quaternionf& q2) {
+    const double dot = (double) q1.w() * q2.w() + (double) q1.x() * q2.x()
+            + (double) q1.y() * q2.y() + (double) q1.z() * q2.z();
+    return std::clamp(dot / ((double) q1.norm() * q2.norm()), -1., 1.);
+}
+
+// Half the angle of the rotation between two quaternions, which is the distance between their
+// directions on the 3-sphere. Unlike their dot product, it satisfies the triangle inequality.
+float halfAngleBetween(const Quaternionf& q1, const Quaternionf& q2) {
+    return std::acos(cosHalfAngleBetween(q1, q2));
+}
+
+}  // namespace
 
 StillnessDetector::StillnessDetector(const Options& options)
     : mOptions(options), mCosHalfRotationalThreshold(cos(mOptions.rotationalThreshold / 2)) {}
 
 void StillnessDetector::reset() {
     mFifo.clear();
+    mFifoStart = 0;
     mWindowFull = false;
     mSuppressionDeadline.reset();
+    mReference.reset();
     // A "true" state indicates stillness is detected (default = true)
     mCurrentState = true;
     mPreviousState = true;
 }
 
 void StillnessDetector::setInput(int64_t timestamp, const Pose3f& input) {
+    // Compact once the expired entries make up half of the storage, which amortizes the move.
+    if (mFifoStart > 0 && mFifoStart >= mFifo.size() / 2) {
+        mFifo.erase(mFifo.begin(), mFifo.begin() + mFifoStart);
+        mFifoStart = 0;
+    }
     mFifo.push_back(TimestampedPose{timestamp, input});
+    if (mReference.has_value()) {
+        mMaxTranslationFromReference = std::max(mMaxTranslationFromReference,
+                                                translationalDistance(input, *mReference));
+        mMaxHalfAngleFromReference = std::max(
+                mMaxHalfAngleFromReference, halfAngleBetween(input.rotation(),
+                                                             mReference->rotation()));
+        mMinRotationNorm = std::min(mMinRotationNorm, input.rotation().norm());
+    }
     discardOld(timestamp);
 }
 
@@ -54,10 +102,14 @@ bool StillnessDetector::calculate(int64_t timestamp) {
     // one ends after the current one.
     bool moved = false;
 
-    if (!mFifo.empty()) {
-        for (auto iter = mFifo.rbegin() + 1; iter != mFifo.rend(); ++iter) {
-            const auto& event = *iter;
-            if (!areNear(event.pose, mFifo.back().pose)) {
+    if (mFifoStart < mFifo.size() && !isWindowNear(mFifo.back().pose)) {
+        const Pose3f& latest = mFifo.back().pose;
+        float maxTranslation = 0;
+        double minCosHalfAngle = 1;
+        float minRotationNorm = latest.rotation().norm();
+        for (size_t i = mFifo.size() - 1; i-- > mFifoStart;) {
+            const auto& event = mFifo[i];
+            if (!areNear(event.pose, latest)) {
                 // Enable suppression for the duration of the window.
                 int64_t deadline = event.timestamp + mOptions.windowDuration;
                 if (!mSuppressionDeadline.has_value() || mSuppressionDeadline.value() < deadline) {
@@ -66,6 +118,19 @@ bool StillnessDetector::calculate(int64_t timestamp) {
                 moved = true;
                 break;
             }
+            maxTranslation = std::max(maxTranslation, translationalDistance(event.pose, latest));
+            minCosHalfAngle = std::min(minCosHalfAngle,
+                                       cosHalfAngleBetween(event.pose.rotation(),
+                                                           latest.rotation()));
+            minRotationNorm = std::min(minRotationNorm, event.pose.rotation().norm());
+        }
+        if (moved) {
+            mReference.reset();
+        } else {
+            mReference = latest;
+            mMaxTranslationFromReference = maxTranslation;
+            mMaxHalfAngleFromReference = std::acos(minCosHalfAngle) + kHalfAngleSlack;
+            mMinRotationNorm = minRotationNorm;
         }
     }
 
@@ -88,15 +153,16 @@ void StillnessDetector::discardOld(int64_t timestamp) {
     // Handle the special case of the window duration being zero (always considered full).
     if (mOptions.windowDuration == 0) {
         mFifo.clear();
+        mFifoStart = 0;
         mWindowFull = true;
     }
 
     // Remove any events from the queue that are older than the window. If there were any such
     // events we consider the window full.
     const int64_t windowStart = timestamp - mOptions.windowDuration;
-    while (!mFifo.empty() && mFifo.front().timestamp <= windowStart) {
+    while (mFifoStart < mFifo.size() && mFifo[mFifoStart].timestamp <= windowStart) {
         mWindowFull = true;
-        mFifo.pop_front();
+        ++mFifoStart;
     }
 
     // Expire the suppression deadline.
@@ -105,6 +171,26 @@ void StillnessDetector::discardOld(int64_t timestamp) {
     }
 }
 
+bool StillnessDetector::isWindowNear(const Pose3f& pose) const {
+    // By the triangle inequality, every pose in the window is near the given one if the distances
+    // from the reference to the window and from the reference to the pose add up to less than
+    // the thresholds. In that case a scan of the window would not find any motion.
+    if (!mReference.has_value()) {
+        return false;
+    }
+    if (mMaxTranslationFromReference + translationalDistance(pose, *mReference)
+            > mOptions.translationalThreshold * kBoundMargin) {
+        return false;
+    }
+    // areNear() compares the plain dot product, which is the cosine of the half angle scaled by
+    // both norms, so the bound on the half angle is scaled by the smallest norm in the window.
+    const double halfAngle = mMaxHalfAngleFromReference
+            + halfAngleBetween(pose.rotation(), mReference->rotation());
+    return halfAngle < M_PI / 2
+           && mMinRotationNorm * pose.rotation().norm() * std::cos(halfAngle)
+                   >= mCosHalfRotationalThreshold + kDotMargin;
+}
+
 bool StillnessDetector::areNear(const Pose3f& pose1, const Pose3f& pose2) const {
     // Check translation. We use the L1 norm to reduce computational load on expense of accuracy.
     // The L1 norm is an upper bound for the actual (L2) norm, so this approach will err on the side
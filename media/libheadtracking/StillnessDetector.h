@@ -15,7 +15,8 @@
  */
 #pragma once
 
-#include <deque>
+#include <optional>
+#include <vector>
 
 #include <media/Pose.h>
 
@@ -91,7 +92,11 @@ class StillnessDetector {
     const Options mOptions;
     // Precalculated cos(mOptions.rotationalThreshold / 2)
     const float mCosHalfRotationalThreshold;
-    std::deque<TimestampedPose> mFifo;
+    // The window, oldest first, begins at mFifoStart. Expired entries at the front are only
+    // compacted away occasionally, so that the storage gets reused and pushing a sample at high
+    // sensor rates does not allocate once the window has been filled.
+    std::vector<TimestampedPose> mFifo;
+    size_t mFifoStart = 0;
     bool mWindowFull = false;
     bool mCurrentState = true;
     bool mPreviousState = true;
@@ -100,8 +105,19 @@ class StillnessDetector {
     // used for hyteresis purposes, since because of the approximate method we use for determining
     // stillness, we may toggle back and forth at a rate faster than the window side.
     std::optional<int64_t> mSuppressionDeadline;
+    // Every pose in the window is known to be within these distances of mReference, which is the
+    // most recent pose of the last full scan of the window that did not detect motion. This lets
+    // calculate() skip the scan, which is linear in the window size, while the stream stays near
+    // that pose. The translational distance uses the L1 norm and the rotational one is half the
+    // rotation angle, matching areNear(). mMinRotationNorm is the smallest norm of the rotations in
+    // the window, which areNear() does not normalize.
+    std::optional<Pose3f> mReference;
+    float mMaxTranslationFromReference = 0;
+    float mMaxHalfAngleFromReference = 0;
+    float mMinRotationNorm = 1;
 
     bool areNear(const Pose3f& pose1, const Pose3f& pose2) const;
+    bool isWindowNear(const Pose3f& pose) const;
     void discardOld(int64_t timestamp);
 };
 
@@ -49,6 +49,13 @@ class HeadTrackingProcessor {
         float screenStillnessRotationalThreshold = std::numeric_limits<float>::infinity();
     };
 
+    /** A single world-to-head sample, see setWorldToHeadPose(). */
+    struct HeadPoseSample {
+        int64_t timestamp;
+        Pose3f worldToHead;
+        Twist3f headTwist;
+    };
+
     /** Sets the desired head-tracking mode. */
     virtual void setDesiredMode(HeadTrackingMode mode) = 0;
 
@@ -59,6 +66,14 @@ class HeadTrackingProcessor {
     virtual void setWorldToHeadPose(int64_t timestamp, const Pose3f& worldToHead,
                                     const Twist3f& headTwist) = 0;
 
+    /**
+     * Sets a block of world-to-head samples, ordered by increasing timestamp.
+     * The result is the same as calling setWorldToHeadPose() for each sample in turn, but stages
+     * that only depend on the most recent sample are run once per block. Intended for high sensor
+     * rates, where samples are delivered in batches between calls to calculate().
+     */
+    virtual void setWorldToHeadPoses(const HeadPoseSample* samples, size_t count) = 0;
+
     /**
      * Sets the world-to-screen pose.
      */
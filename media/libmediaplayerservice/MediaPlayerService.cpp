@@ -2488,6 +2488,18 @@ ssize_t MediaPlayerService::AudioOutput::write(const void* buffer, size_t size,
     return NO_INIT;
 }
 
+ssize_t MediaPlayerService::AudioOutput::writev(
+        const struct iovec* iov, int iovcnt, bool blocking)
+{
+    Mutex::Autolock lock(mLock);
+    LOG_ALWAYS_FATAL_IF(mCallback != NULL, "Don't call write if supplying a callback.");
+
+    if (mTrack != 0) {
+        return mTrack->writev(iov, iovcnt, blocking);
+    }
+    return NO_INIT;
+}
+
 void MediaPlayerService::AudioOutput::stop()
 {
     ALOGV("stop");
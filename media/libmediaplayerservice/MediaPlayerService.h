@@ -117,6 +117,7 @@ class MediaPlayerService : public BnMediaPlayerService
 
         virtual status_t        start();
         virtual ssize_t         write(const void* buffer, size_t size, bool blocking = true);
+        virtual ssize_t         writev(const struct iovec* iov, int iovcnt, bool blocking = true);
         virtual void            stop();
         virtual void            flush();
         virtual void            pause();
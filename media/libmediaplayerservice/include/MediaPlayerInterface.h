@@ -20,6 +20,7 @@
 #ifdef __cplusplus
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <utils/Errors.h>
 #include <utils/KeyedVector.h>
 #include <utils/String8.h>
@@ -139,6 +140,26 @@ public:
          */
         virtual ssize_t     write(const void* buffer, size_t size, bool blocking = true) = 0;
 
+        /* As write(), but gathers the data from |iovcnt| buffers, written back to back
+         * as if they were one, so small buffers need not be copied together first.
+         * Returns the total number of bytes written, which stops short at the first
+         * buffer not written in full.
+         */
+        virtual ssize_t     writev(const struct iovec* iov, int iovcnt, bool blocking = true) {
+            ssize_t total = 0;
+            for (int i = 0; i < iovcnt; ++i) {
+                ssize_t written = write(iov[i].iov_base, iov[i].iov_len, blocking);
+                if (written < 0) {
+                    return total > 0 ? total : written;
+                }
+                total += written;
+                if ((size_t)written != iov[i].iov_len) {
+                    break;
+                }
+            }
+            return total;
+        }
+
         virtual void        stop() = 0;
         virtual void        flush() = 0;
         virtual void        pause() = 0;
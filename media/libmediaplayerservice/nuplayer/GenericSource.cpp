@@ -52,6 +52,32 @@ static const int kInitialMarkMs        = 5000;  // 5secs
 //static const int kPausePlaybackMarkMs  = 2000;  // 2secs
 static const int kResumePlaybackMarkMs = 15000;  // 15secs
 
+// Local playback reads ahead enough media to ride out several of the slowest
+// recent reads at the rate the decoders consume it, so that slow storage (SD
+// cards, network mounts) doesn't starve them. Reading resumes once half of it
+// has been consumed, so buffers are read in large batches rather than a few per
+// message.
+static const int64_t kMinReadAheadUs = 250000LL;
+static const int64_t kMaxReadAheadUs = 2000000LL;
+static const int64_t kReadAheadStallFactor = 8;
+static const size_t kMaxReadAheadBuffers = 256;
+// Buffers only reach the decoders once a read returns, so a read asks for few
+// of them: its duration is then a stall the decoders see, not a batch size.
+static const size_t kMaxReadAheadBuffersPerRead = 16;
+// A batch longer than this continues in a new message, to not hold off seeks.
+static const int64_t kMaxReadBatchDurationUs = 50000LL;
+// Consumption is measured over windows of about this much real time.
+static const int64_t kConsumptionWindowUs = 1000000LL;
+
+static int64_t readAheadUs(int64_t readStallUs, int64_t consumedUsPerSec) {
+    int64_t readAheadUs =
+            readStallUs * kReadAheadStallFactor * consumedUsPerSec / 1000000LL;
+    if (readAheadUs < kMinReadAheadUs) {
+        return kMinReadAheadUs;
+    }
+    return readAheadUs > kMaxReadAheadUs ? kMaxReadAheadUs : readAheadUs;
+}
+
 NuPlayer::GenericSource::GenericSource(
         const sp<AMessage> &notify,
         bool uidValid,
@@ -867,7 +893,9 @@ status_t NuPlayer::GenericSource::dequeueAccessUnit(
     // start pulling in more buffers if cache is running low
     // so that decoder has less chance of being starved
     if (!mIsStreaming) {
-        if (track->mPackets->getAvailableBufferCount(&finalResult) < 2) {
+        if (track->mPackets->getAvailableBufferCount(&finalResult) < 2
+                || track->mPackets->getBufferedDurationUs(&finalResult)
+                        < readAheadUs(track->mReadStallUs, track->mConsumedUsPerSec) / 2) {
             postReadBuffer(audio? MEDIA_TRACK_TYPE_AUDIO : MEDIA_TRACK_TYPE_VIDEO);
         }
     } else {
@@ -912,6 +940,9 @@ status_t NuPlayer::GenericSource::dequeueAccessUnit(
     } else {
         mVideoLastDequeueTimeUs = timeUs;
     }
+    if (!mIsStreaming) {
+        updateConsumption(track, timeUs);
+    }
 
     if (mSubtitleTrack.mSource != NULL
             && !mSubtitleTrack.mPackets->hasBufferAvailable(&eosResult)) {
@@ -1167,12 +1198,14 @@ status_t NuPlayer::GenericSource::doSeek(int64_t seekTimeUs, MediaPlayerSeekMode
             seekTimeUs = std::max<int64_t>(0, actualTimeUs);
         }
         mVideoLastDequeueTimeUs = actualTimeUs;
+        mVideoTrack.mConsumptionStartUs = -1;
     }
 
     if (mAudioTrack.mSource != NULL) {
         ++mAudioDataGeneration;
         readBuffer(MEDIA_TRACK_TYPE_AUDIO, seekTimeUs, MediaPlayerSeekMode::SEEK_CLOSEST);
         mAudioLastDequeueTimeUs = seekTimeUs;
+        mAudioTrack.mConsumptionStartUs = -1;
     }
 
     if (mSubtitleTrack.mSource != NULL) {
@@ -1366,6 +1399,15 @@ void NuPlayer::GenericSource::readBuffer(
         seeking = true;
     }
 
+    // Local playback fills up to the read-ahead duration, a seek only reads the
+    // first buffers so that it completes quickly.
+    const bool readAhead = !mIsStreaming && !seeking
+            && (trackType == MEDIA_TRACK_TYPE_AUDIO || trackType == MEDIA_TRACK_TYPE_VIDEO);
+    if (readAhead) {
+        maxBuffers = kMaxReadAheadBuffers;
+    }
+    const int64_t batchStartUs = ALooper::GetNowUs();
+
     const bool couldReadMultiple = (track->mSource->supportReadMultiple());
 
     if (couldReadMultiple) {
@@ -1378,10 +1420,14 @@ void NuPlayer::GenericSource::readBuffer(
         status_t err = NO_ERROR;
 
         sp<IMediaSource> source = track->mSource;
+        const int64_t readStartUs = ALooper::GetNowUs();
         mLock.unlock();
         if (couldReadMultiple) {
-            err = source->readMultiple(
-                    &mediaBuffers, maxBuffers - numBuffers, &options);
+            size_t numToRead = maxBuffers - numBuffers;
+            if (readAhead && numToRead > kMaxReadAheadBuffersPerRead) {
+                numToRead = kMaxReadAheadBuffersPerRead;
+            }
+            err = source->readMultiple(&mediaBuffers, numToRead, &options);
         } else {
             MediaBufferBase *mbuf = NULL;
             err = source->read(&mbuf, &options);
@@ -1391,6 +1437,13 @@ void NuPlayer::GenericSource::readBuffer(
         }
         mLock.lock();
 
+        if (readAhead) {
+            // The decoders get nothing from a read until it returns.
+            const int64_t readUs = ALooper::GetNowUs() - readStartUs;
+            const int64_t decayedUs = track->mReadStallUs - track->mReadStallUs / 16;
+            track->mReadStallUs = readUs > decayedUs ? readUs : decayedUs;
+        }
+
         options.clearNonPersistent();
 
         size_t id = 0;
@@ -1461,6 +1514,18 @@ void NuPlayer::GenericSource::readBuffer(
             track->mPackets->signalEOS(err);
             break;
         }
+
+        if (readAhead) {
+            status_t finalResult;
+            if (track->mPackets->getBufferedDurationUs(&finalResult)
+                    >= readAheadUs(track->mReadStallUs, track->mConsumedUsPerSec)) {
+                break;
+            }
+            if (ALooper::GetNowUs() - batchStartUs >= kMaxReadBatchDurationUs) {
+                postReadBuffer(trackType);
+                break;
+            }
+        }
     }
 
     if (mIsStreaming
@@ -1499,6 +1564,22 @@ void NuPlayer::GenericSource::readBuffer(
     }
 }
 
+void NuPlayer::GenericSource::updateConsumption(Track *track, int64_t timeUs) {
+    const int64_t nowUs = ALooper::GetNowUs();
+    if (track->mConsumptionStartUs < 0 || timeUs < track->mConsumptionStartMediaUs) {
+        track->mConsumptionStartUs = nowUs;
+        track->mConsumptionStartMediaUs = timeUs;
+        return;
+    }
+    const int64_t elapsedUs = nowUs - track->mConsumptionStartUs;
+    if (elapsedUs >= kConsumptionWindowUs) {
+        track->mConsumedUsPerSec =
+                (timeUs - track->mConsumptionStartMediaUs) * 1000000LL / elapsedUs;
+        track->mConsumptionStartUs = nowUs;
+        track->mConsumptionStartMediaUs = timeUs;
+    }
+}
+
 void NuPlayer::GenericSource::queueDiscontinuityIfNeeded(
         bool seeking, bool formatChange, media_track_type trackType, Track *track) {
     // formatChange && seeking: track whose source is changed during selection
@@ -82,6 +82,9 @@ static const int64_t kMaxAllowedAudioSinkDelayUs = 1500000LL;
 
 static const int64_t kMinimumAudioClockUpdatePeriodUs = 20 /* msec */ * 1000;
 
+// Maximum number of queued audio buffers gathered into one AudioSink write.
+static const int kMaxAudioBuffersPerWrite = 16;
+
 // Default video frame display duration when only video exists.
 // Used to set max media time in MediaClock.
 static const int64_t kDefaultVideoFrameIntervalUs = 100000LL;
@@ -1155,10 +1158,27 @@ bool NuPlayer::Renderer::onDrainAudioQueue() {
             onNewAudioMediaTime(mediaTimeUs);
         }
 
-        size_t copy = entry->mBuffer->size() - entry->mOffset;
-
-        ssize_t written = mAudioSink->write(entry->mBuffer->data() + entry->mOffset,
-                                            copy, false /* blocking */);
+        // Write the run of PCM buffers at the head of the queue at once, so that small
+        // decoder outputs share one transfer into the AudioSink. Only whole frames are
+        // gathered; a buffer with a fractional frame is written on its own.
+        const size_t frameSize = mAudioSink->frameSize();
+        struct iovec iov[kMaxAudioBuffersPerWrite];
+        int iovcnt = 0;
+        size_t copy = 0;
+        List<QueueEntry>::iterator it = mAudioQueue.begin();
+        do {
+            iov[iovcnt].iov_base = it->mBuffer->data() + it->mOffset;
+            iov[iovcnt].iov_len = it->mBuffer->size() - it->mOffset;
+            copy += iov[iovcnt].iov_len;
+            ++iovcnt;
+            ++it;
+        } while (iovcnt < kMaxAudioBuffersPerWrite && it != mAudioQueue.end()
+                && it->mBuffer != NULL && copy % frameSize == 0
+                && it->mBuffer->size() % frameSize == 0);
+
+        ssize_t written = iovcnt == 1
+                ? mAudioSink->write(iov[0].iov_base, copy, false /* blocking */)
+                : mAudioSink->writev(iov, iovcnt, false /* blocking */);
         if (written < 0) {
             // An error in AudioSink write. Perhaps the AudioSink was not properly opened.
             if (written == WOULD_BLOCK) {
@@ -1172,9 +1192,34 @@ bool NuPlayer::Renderer::onDrainAudioQueue() {
             break;
         }
 
-        entry->mOffset += written;
-        size_t remainder = entry->mBuffer->size() - entry->mOffset;
-        if ((ssize_t)remainder < mAudioSink->frameSize()) {
+        // Hand the written bytes back out to the buffers they came from; the codec
+        // buffers filled by this write are all returned to the decoder together.
+        size_t writtenLeft = written;
+        for (int i = 0; i < iovcnt; ++i) {
+            entry = &*mAudioQueue.begin();
+            if (i > 0 && entry->mBuffer->size() > 0) {
+                if (writtenLeft == 0) {
+                    break;
+                }
+                // mNumFramesWritten is where this buffer starts
+                int64_t mediaTimeUs;
+                CHECK(entry->mBuffer->meta()->findInt64("timeUs", &mediaTimeUs));
+                onNewAudioMediaTime(mediaTimeUs);
+            }
+            mLastAudioBufferDrained = entry->mBufferOrdinal;
+
+            size_t consumed = entry->mBuffer->size() - entry->mOffset;
+            if (consumed > writtenLeft) {
+                consumed = writtenLeft;
+            }
+            entry->mOffset += consumed;
+            writtenLeft -= consumed;
+            mNumFramesWritten += consumed / frameSize;
+
+            size_t remainder = entry->mBuffer->size() - entry->mOffset;
+            if (remainder >= frameSize) {
+                break;
+            }
             if (remainder > 0) {
                 ALOGW("Corrupted audio buffer has fractional frames, discarding %zu bytes.",
                         remainder);
@@ -1184,13 +1229,9 @@ bool NuPlayer::Renderer::onDrainAudioQueue() {
 
             entry->mNotifyConsumed->post();
             mAudioQueue.erase(mAudioQueue.begin());
-
             entry = NULL;
         }
 
-        size_t copiedFrames = written / mAudioSink->frameSize();
-        mNumFramesWritten += copiedFrames;
-
         {
             Mutex::Autolock autoLock(mLock);
             int64_t maxTimeMedia;
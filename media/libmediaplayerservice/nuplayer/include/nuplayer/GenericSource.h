@@ -122,6 +122,13 @@ private:
         size_t mIndex;
         sp<IMediaSource> mSource;
         sp<AnotherPacketSource> mPackets;
+        // Local read-ahead is sized from the decaying maximum of the time one read
+        // held buffers back from the decoders, and from how fast they consume media.
+        int64_t mReadStallUs = 0;
+        int64_t mConsumedUsPerSec = 1000000LL;
+        // Real and media time the current consumption window started at, -1 if none.
+        int64_t mConsumptionStartUs = -1;
+        int64_t mConsumptionStartMediaUs = 0;
     };
 
     Vector<sp<IMediaSource> > mSources;
@@ -220,6 +227,7 @@ private:
 
     void queueDiscontinuityIfNeeded(
             bool seeking, bool formatChange, media_track_type trackType, Track *track);
+    void updateConsumption(Track *track, int64_t timeUs);
 
     void schedulePollBuffering();
     void onPollBuffering();
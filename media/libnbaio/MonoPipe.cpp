@@ -162,6 +162,30 @@ ssize_t MonoPipe::write(const void *buffer, size_t count)
     return totalFramesWritten;
 }
 
+ssize_t MonoPipe::obtain(NBAIO_Iovec iovec[2], size_t count)
+{
+    if (CC_UNLIKELY(!mNegotiated)) {
+        return NEGOTIATE;
+    }
+    audio_utils_iovec fifoIovec[2];
+    ssize_t actual = mFifoWriter.obtain(fifoIovec, count, NULL /*timeout*/);
+    ALOG_ASSERT(actual <= (ssize_t) count);
+    if (actual <= 0) {
+        return actual;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        iovec[i].mBase = (char *) mBuffer + (fifoIovec[i].mOffset * mFrameSize);
+        iovec[i].mFrames = fifoIovec[i].mLength;
+    }
+    return actual;
+}
+
+void MonoPipe::release(size_t count)
+{
+    mFifoWriter.release(count);
+    mFramesWritten += count;
+}
+
 void MonoPipe::setAvgFrames(size_t setpoint)
 {
     mSetpoint = setpoint;
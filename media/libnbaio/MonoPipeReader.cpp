@@ -55,6 +55,30 @@ ssize_t MonoPipeReader::read(void *buffer, size_t count)
     return actual;
 }
 
+ssize_t MonoPipeReader::obtain(NBAIO_Iovec iovec[2], size_t count)
+{
+    if (CC_UNLIKELY(!mNegotiated)) {
+        return NEGOTIATE;
+    }
+    audio_utils_iovec fifoIovec[2];
+    ssize_t actual = mFifoReader.obtain(fifoIovec, count, NULL /*timeout*/, NULL /*lost*/);
+    ALOG_ASSERT(actual <= (ssize_t) count);
+    if (CC_UNLIKELY(actual <= 0)) {
+        return actual;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        iovec[i].mBase = (char *) mPipe->mBuffer + (fifoIovec[i].mOffset * mFrameSize);
+        iovec[i].mFrames = fifoIovec[i].mLength;
+    }
+    return actual;
+}
+
+void MonoPipeReader::release(size_t count)
+{
+    mFifoReader.release(count);
+    mFramesRead += count;
+}
+
 void MonoPipeReader::onTimestamp(const ExtendedTimestamp &timestamp)
 {
     mPipe->mTimestampMutator.push(timestamp);
@@ -25,7 +25,8 @@ namespace android {
 SourceAudioBufferProvider::SourceAudioBufferProvider(const sp<NBAIO_Source>& source) :
     mSource(source),
     // mFrameSize below
-    mAllocated(NULL), mSize(0), mOffset(0), mRemaining(0), mGetCount(0), mFramesReleased(0)
+    mAllocated(NULL), mSize(0), mOffset(0), mRemaining(0), mGetCount(0), mObtained(false),
+    mFramesReleased(0)
 {
     ALOG_ASSERT(source != 0);
 
@@ -58,6 +59,22 @@ status_t SourceAudioBufferProvider::getNextBuffer(Buffer *buffer)
         mGetCount = buffer->frameCount;
         return OK;
     }
+    {
+        // if the source supports direct access, provide its frames in place instead of copying
+        NBAIO_Iovec iovec[2];
+        ssize_t obtained = mSource->obtain(iovec, buffer->frameCount);
+        if (obtained != INVALID_OPERATION) {
+            if (obtained <= 0) {
+                goto fail;
+            }
+            // a wrapped second segment is returned by the next getNextBuffer()
+            buffer->raw = iovec[0].mBase;
+            buffer->frameCount = iovec[0].mFrames;
+            mGetCount = iovec[0].mFrames;
+            mObtained = true;
+            return OK;
+        }
+    }
     // do we need to reallocate?
     if (buffer->frameCount > mSize) {
         free(mAllocated);
@@ -93,6 +110,16 @@ fail:
 
 void SourceAudioBufferProvider::releaseBuffer(Buffer *buffer)
 {
+    if (mObtained) {
+        ALOG_ASSERT((buffer != NULL) && (buffer->frameCount <= mGetCount));
+        mSource->release(buffer->frameCount);
+        mObtained = false;
+        mFramesReleased += buffer->frameCount;
+        buffer->raw = NULL;
+        buffer->frameCount = 0;
+        mGetCount = 0;
+        return;
+    }
     ALOG_ASSERT((buffer != NULL) &&
             (buffer->raw == (char *) mAllocated + (mOffset * mFrameSize)) &&
             (buffer->frameCount <= mGetCount) &&
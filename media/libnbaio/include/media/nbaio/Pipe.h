@@ -57,6 +57,9 @@ public:
     virtual ssize_t write(const void *buffer, size_t count);
     //virtual ssize_t writeVia(writeVia_t via, size_t total, void *user, size_t block);
 
+    virtual ssize_t obtain(NBAIO_Iovec iovec[2], size_t count);
+    virtual void    release(size_t count);
+
 private:
     const size_t    mMaxFrames;     // always a power of 2
     void * const    mBuffer;
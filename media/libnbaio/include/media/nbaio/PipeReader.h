@@ -47,6 +47,9 @@ public:
 
     virtual ssize_t read(void *buffer, size_t count);
 
+    // obtain() is not supported: the Pipe writer is not throttled by its readers,
+    // so it could overwrite frames while they are being accessed in place.
+
     virtual ssize_t flush();
 
     // NBAIO_Source end
@@ -47,6 +47,8 @@ private:
     size_t              mOffset;    // frame offset within mAllocated of valid data
     size_t              mRemaining; // frame count within mAllocated of valid data
     size_t              mGetCount;  // buffer.frameCount of the most recent getNextBuffer
+    bool                mObtained;  // whether the most recent getNextBuffer obtained the frames
+                                    // in place from mSource, rather than copying to mAllocated
     int64_t             mFramesReleased;    // counter of the total number of frames released
 };
 
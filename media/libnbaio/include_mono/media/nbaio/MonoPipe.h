@@ -63,6 +63,10 @@ public:
     virtual ssize_t write(const void *buffer, size_t count);
     //virtual ssize_t writeVia(writeVia_t via, size_t total, void *user, size_t block);
 
+    // Unlike write(), obtain() is never throttled, even if writeCanBlock was requested.
+    virtual ssize_t obtain(NBAIO_Iovec iovec[2], size_t count);
+    virtual void    release(size_t count);
+
             // average number of frames present in the pipe under normal conditions.
             // See throttling mechanism in MonoPipe::write()
             size_t  getAvgFrames() const { return mSetpoint; }
@@ -49,6 +49,10 @@ public:
 
     virtual ssize_t read(void *buffer, size_t count);
 
+    // Reading in place is safe because the MonoPipe writer is throttled by this reader.
+    virtual ssize_t obtain(NBAIO_Iovec iovec[2], size_t count);
+    virtual void    release(size_t count);
+
     virtual void    onTimestamp(const ExtendedTimestamp &timestamp);
 
     // NBAIO_Source end
@@ -84,6 +84,13 @@ unsigned Format_channelCount(const NBAIO_Format& format);
 typedef ssize_t (*writeVia_t)(void *user, void *buffer, size_t count);
 typedef ssize_t (*readVia_t)(void *user, const void *buffer, size_t count);
 
+// A contiguous run of frames in memory owned by a sink or source.
+// Used by NBAIO_Sink::obtain() and NBAIO_Source::obtain() below.
+struct NBAIO_Iovec {
+    void   *mBase;      // address of the first frame
+    size_t  mFrames;    // number of frames
+};
+
 // Check whether an NBAIO_Format is valid
 bool Format_isValid(const NBAIO_Format& format);
 
@@ -217,6 +224,22 @@ public:
     //  < 0     status_t error occurred prior to the first frame transfer during this callback.
     virtual ssize_t writeVia(writeVia_t via, size_t total, void *user, size_t block = 0);
 
+    // Direct access to the sink's own buffer, which avoids the copy implied by write().
+    // Obtains space for up to 'count' frames as one or two segments. The second segment is
+    // needed only when the space wraps around the end of a circular buffer, otherwise its
+    // mFrames is zero. The caller fills the segments in order and then calls release() with the
+    // number of frames actually written, which must not exceed the value returned by obtain().
+    // obtain() does not block, even for sinks whose write() can block.
+    // Return value:
+    //  > 0     Total number of frames in iovec[0] and iovec[1].
+    //  = 0     Count was zero, or there is no space available.
+    //  < 0     status_t error occurred.
+    // Errors:
+    //  NEGOTIATE         (Re-)negotiation is needed.
+    //  INVALID_OPERATION Direct access is not supported by this sink, use write() instead.
+    virtual ssize_t obtain(NBAIO_Iovec /*iovec*/[2], size_t /*count*/) { return INVALID_OPERATION; }
+    virtual void    release(size_t /*count*/) { }
+
     // Returns NO_ERROR if a timestamp is available.  The timestamp includes the total number
     // of frames presented to an external observer, together with the value of CLOCK_MONOTONIC
     // as of this presentation count.  The timestamp parameter is undefined if error is returned.
@@ -316,6 +339,21 @@ public:
     //  < 0     status_t error occurred prior to the first frame transfer during this callback.
     virtual ssize_t readVia(readVia_t via, size_t total, void *user, size_t block = 0);
 
+    // Direct access to the source's own buffer, which avoids the copy implied by read().
+    // Obtains up to 'count' frames as one or two segments. The second segment is needed only
+    // when the data wraps around the end of a circular buffer, otherwise its mFrames is zero.
+    // The frames stay valid until release() is called with the number of frames consumed,
+    // which must not exceed the value returned by obtain().
+    // Return value:
+    //  > 0     Total number of frames in iovec[0] and iovec[1].
+    //  = 0     Count was zero, or there is no data available.
+    //  < 0     status_t error occurred.
+    // Errors:
+    //  NEGOTIATE         (Re-)negotiation is needed.
+    //  INVALID_OPERATION Direct access is not supported by this source, use read() instead.
+    virtual ssize_t obtain(NBAIO_Iovec /*iovec*/[2], size_t /*count*/) { return INVALID_OPERATION; }
+    virtual void    release(size_t /*count*/) { }
+
     // Invoked asynchronously by corresponding sink when a new timestamp is available.
     // Default implementation ignores the timestamp.
     virtual void    onTimestamp(const ExtendedTimestamp& /*timestamp*/) { }
@@ -147,6 +147,13 @@ void MergeReader::processSnapshot(Snapshot &snapshot, int author)
         } break;
         case EVENT_THREAD_INFO: {
             const thread_info_t info = it.payload<thread_info_t>();
+            if (info.type != data.threadInfo.type && info.type != FASTMIXER
+                    && info.type != FASTCAPTURE && info.type != UNKNOWN) {
+                // the work histogram was created for fast threads, which log their cycle
+                // time, switch to the processing times logged by normal playback threads
+                data.workHist = ReportPerformance::Histogram(
+                        ReportPerformance::PerformanceData::kPlaybackWorkConfig);
+            }
             data.threadInfo = info;
         } break;
         case EVENT_THREAD_PARAMS: {
@@ -179,7 +186,7 @@ void MergeReader::processSnapshot(Snapshot &snapshot, int author)
         case EVENT_OVERRUN: {
             const int64_t ts = it.payload<int64_t>();
             data.overruns++;
-            data.snapshots.emplace_front(EVENT_UNDERRUN, ts);
+            data.snapshots.emplace_front(EVENT_OVERRUN, ts);
             // TODO have a data structure to automatically handle resizing
             if (data.snapshots.size() > ReportPerformance::PerformanceData::kMaxSnapshotsToStore) {
                 data.snapshots.pop_back();
@@ -200,14 +207,14 @@ void MergeReader::getAndProcessSnapshot()
     // get a snapshot of each reader and process them
     // TODO insert lock here
     const size_t nLogs = mReaders.size();
-    std::vector<std::unique_ptr<Snapshot>> snapshots(nLogs);
+    mSnapshots.resize(nLogs);
     for (size_t i = 0; i < nLogs; i++) {
-        snapshots[i] = mReaders[i]->getSnapshot();
+        mSnapshots[i] = mReaders[i]->getSnapshot(true /*flush*/, std::move(mSnapshots[i]));
     }
     // TODO unlock lock here
     for (size_t i = 0; i < nLogs; i++) {
-        if (snapshots[i] != nullptr) {
-            processSnapshot(*(snapshots[i]), i);
+        if (mSnapshots[i] != nullptr) {
+            processSnapshot(*(mSnapshots[i]), i);
         }
     }
     checkPushToMediaMetrics();
@@ -229,7 +236,7 @@ void MergeReader::dump(int fd, const Vector<String16>& args)
 {
     // TODO: add a mutex around media.log dump
     // Options for dumpsys
-    bool pa = false, json = false, plots = false, retro = false;
+    bool pa = false, json = false, plots = false, retro = false, binary = false;
     for (const auto &arg : args) {
         if (arg == String16("--pa")) {
             pa = true;
@@ -239,6 +246,8 @@ void MergeReader::dump(int fd, const Vector<String16>& args)
             plots = true;
         } else if (arg == String16("--retro")) {
             retro = true;
+        } else if (arg == String16("--binary")) {
+            binary = true;
         }
     }
     if (pa) {
@@ -253,6 +262,9 @@ void MergeReader::dump(int fd, const Vector<String16>& args)
     if (retro) {
         ReportPerformance::dumpRetro(fd, mThreadPerformanceData);
     }
+    if (binary) {
+        ReportPerformance::dumpBinary(fd, mThreadPerformanceData);
+    }
 }
 
 void MergeReader::handleAuthor(const AbstractEntry &entry, String8 *body)
@@ -64,10 +64,20 @@ Reader::~Reader()
 // Copies content of a Reader FIFO into its Snapshot
 // The Snapshot has the same raw data, but represented as a sequence of entries
 // and an EntryIterator making it possible to process the data.
-std::unique_ptr<Snapshot> Reader::getSnapshot(bool flush)
+std::unique_ptr<Snapshot> Reader::getSnapshot(bool flush, std::unique_ptr<Snapshot> recycled)
 {
+    // Empty snapshot, keeping the recycled buffer (if any) for the next call.
+    const auto emptySnapshot = [&recycled]() {
+        if (recycled == nullptr) {
+            return std::unique_ptr<Snapshot>(new Snapshot());
+        }
+        recycled->mBegin = recycled->mEnd = EntryIterator();
+        recycled->mLost = 0;
+        return std::move(recycled);
+    };
+
     if (mFifoReader == NULL) {
-        return std::unique_ptr<Snapshot>(new Snapshot());
+        return emptySnapshot();
     }
 
     // This emulates the behaviour of audio_utils_fifo_reader::read, but without incrementing the
@@ -97,7 +107,7 @@ std::unique_ptr<Snapshot> Reader::getSnapshot(bool flush)
 
     if (availToRead <= 0) {
         ALOGW_IF(availToRead < 0, "NBLog Reader %s failed to catch up with Writer", mName.c_str());
-        return std::unique_ptr<Snapshot>(new Snapshot());
+        return emptySnapshot();
     }
 
     // Change to #if 1 for debugging. This statement is useful for checking buffer fullness levels
@@ -111,10 +121,17 @@ std::unique_ptr<Snapshot> Reader::getSnapshot(bool flush)
     ALOGD("getSnapshot name=%s, availToRead=%zd, capacity=%zu, fullness=%.3f, lost=%zu",
             name().c_str(), availToRead, capacity, (double)availToRead / (double)capacity, lost);
 #endif
-    std::unique_ptr<Snapshot> snapshot(new Snapshot(availToRead));
-    memcpy(snapshot->mData, (const char *) mFifo->buffer() + iovec[0].mOffset, iovec[0].mLength);
+    std::unique_ptr<Snapshot> snapshot;
+    if (recycled != nullptr && recycled->mCapacity >= (size_t) availToRead) {
+        snapshot = std::move(recycled);
+        snapshot->mBegin = snapshot->mEnd = EntryIterator();
+    } else {
+        snapshot.reset(new Snapshot(availToRead));
+    }
+    memcpy(snapshot->mData.get(), (const char *) mFifo->buffer() + iovec[0].mOffset,
+            iovec[0].mLength);
     if (iovec[1].mLength > 0) {
-        memcpy(snapshot->mData + (iovec[0].mLength),
+        memcpy(snapshot->mData.get() + (iovec[0].mLength),
                 (const char *) mFifo->buffer() + iovec[1].mOffset, iovec[1].mLength);
     }
 
@@ -124,8 +141,8 @@ std::unique_ptr<Snapshot> Reader::getSnapshot(bool flush)
     // it ends in a complete entry (which is not an FMT_END). So is safe to traverse backwards.
     // TODO: handle client corruption (in the middle of a buffer)
 
-    const uint8_t *back = snapshot->mData + availToRead;
-    const uint8_t *front = snapshot->mData;
+    const uint8_t *back = snapshot->mData.get() + availToRead;
+    const uint8_t *front = snapshot->mData.get();
 
     // Find last FMT_END. <back> is sitting on an entry which might be the middle of a FormatEntry.
     // We go backwards until we find an EVENT_FMT_END.
@@ -148,6 +148,52 @@ void dumpRetro(int fd, const std::map<int, PerformanceData>& threadDataMap)
     }
 }
 
+template <typename T>
+static void appendBinary(std::string& out, T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void appendBinary(std::string& out, const Histogram& hist)
+{
+    const Histogram::Config config = hist.config();
+    appendBinary<double>(out, config.binSize);
+    appendBinary<double>(out, config.low);
+    appendBinary<uint32_t>(out, config.numBins);
+    const std::vector<uint64_t>& bins = hist.bins();
+    out.append(reinterpret_cast<const char*>(bins.data()), bins.size() * sizeof(uint64_t));
+}
+
+void dumpBinary(int fd, const std::map<int, PerformanceData>& threadDataMap)
+{
+    static constexpr char kMagic[4] = {'N', 'B', 'P', 'D'};
+    static constexpr uint32_t kVersion = 1;
+
+    if (fd < 0) {
+        return;
+    }
+
+    const nsecs_t now = systemTime();
+    std::string out(kMagic, sizeof(kMagic));
+    appendBinary<uint32_t>(out, kVersion);
+    appendBinary<uint32_t>(out, threadDataMap.size());
+    for (const auto &item : threadDataMap) {
+        const ReportPerformance::PerformanceData& data = item.second;
+        appendBinary<int32_t>(out, data.threadInfo.id);
+        appendBinary<int32_t>(out, data.threadInfo.type);
+        appendBinary<uint64_t>(out, data.threadParams.frameCount);
+        appendBinary<uint32_t>(out, data.threadParams.sampleRate);
+        appendBinary<int64_t>(out, data.underruns);
+        appendBinary<int64_t>(out, data.overruns);
+        appendBinary<int64_t>(out, data.active);
+        appendBinary<int64_t>(out, now - data.start);
+        appendBinary(out, data.workHist);
+        appendBinary(out, data.latencyHist);
+        appendBinary(out, data.warmupHist);
+    }
+    write(fd, out.data(), out.size());
+}
+
 bool sendToMediaMetrics(const PerformanceData& data)
 {
     // See documentation for these metrics here:
@@ -95,6 +95,12 @@ enum ThreadType {
     CAPTURE,
     FASTMIXER,
     FASTCAPTURE,
+    // Normal playback threads other than MIXER. Values are appended, as they are dumped.
+    DIRECT,
+    DUPLICATING,
+    OFFLOAD,
+    SPATIALIZER,
+    BIT_PERFECT,
 };
 
 inline const char *threadTypeToString(ThreadType type) {
@@ -107,6 +113,16 @@ inline const char *threadTypeToString(ThreadType type) {
         return "FASTMIXER";
     case FASTCAPTURE:
         return "FASTCAPTURE";
+    case DIRECT:
+        return "DIRECT";
+    case DUPLICATING:
+        return "DUPLICATING";
+    case OFFLOAD:
+        return "OFFLOAD";
+    case SPATIALIZER:
+        return "SPATIALIZER";
+    case BIT_PERFECT:
+        return "BIT_PERFECT";
     case UNKNOWN:
     default:
         return "UNKNOWN";
@@ -103,6 +103,10 @@ private:
     // first parameter is author, i.e. thread index.
     std::map<int, ReportPerformance::PerformanceData> mThreadPerformanceData;
 
+    // one snapshot per reader, kept between calls to getAndProcessSnapshot() so that the
+    // periodic merge reuses the snapshot buffers instead of allocating them every time.
+    std::vector<std::unique_ptr<Snapshot>> mSnapshots;
+
     // how often to push data to Media Metrics
     static constexpr nsecs_t kPeriodicMediaMetricsPush = s2ns((nsecs_t)2 * 60 * 60); // 2 hours
 
@@ -94,6 +94,20 @@ public:
      */
     uint64_t totalCount() const;
 
+    /**
+     * \brief Returns the raw bin counts, without any serialization.
+     *
+     * \return the bin counts. Index 0 holds the count of values below the lower bound,
+     *         index numBins + 1 the count of values at or above the upper bound, and
+     *         index binIndex + 1 the count of bin binIndex.
+     */
+    const std::vector<uint64_t>& bins() const { return mBins; }
+
+    /**
+     * \brief Returns the configuration the histogram was created with.
+     */
+    Config config() const { return {mBinSize, mNumBins, mLow}; }
+
     /**
      * \brief Serializes the histogram into a string. The format is chosen to be compatible with
      *        the histogram representation to send to the Media Metrics service.
@@ -121,9 +135,11 @@ private:
     // Histogram version number.
     static constexpr int kVersion = 1;
 
-    const double mBinSize;          // Size of each bucket
-    const size_t mNumBins;          // Number of buckets in range (excludes low and high)
-    const double mLow;              // Lower bound of values
+    // Not const so that a histogram can be replaced by one with a different configuration,
+    // e.g. once the type of the thread it is recording is known.
+    double mBinSize;                // Size of each bucket
+    size_t mNumBins;                // Number of buckets in range (excludes low and high)
+    double mLow;                    // Lower bound of values
 
     // Data structure to store the actual histogram. Counts of bin values less than mLow
     // are stored in mBins[0]. Bin index i corresponds to mBins[i+1]. Counts of bin values
@@ -144,6 +160,10 @@ struct PerformanceData {
     // and mSampleRate = 48000, which correspond to 2 and 7 seconds.
     static constexpr Histogram::Config kWorkConfig = { 0.25, 20, 2.};
 
+    // Normal playback threads log the time spent processing a period, which is up to
+    // the 10 to 40 ms of the period itself. Most of it would fall below kWorkConfig.
+    static constexpr Histogram::Config kPlaybackWorkConfig = { 0.5, 40, 0.};
+
     // Values based on trial and error logging. Need a better way to determine
     // bin size and lower/upper limits.
     static constexpr Histogram::Config kLatencyConfig = { 2., 10, 10.};
@@ -50,8 +50,11 @@ public:
     Reader(const sp<IMemory>& iMemory, size_t size, const std::string &name);
     ~Reader() override;
 
-    // get snapshot of readers fifo buffer, effectively consuming the buffer
-    std::unique_ptr<Snapshot> getSnapshot(bool flush = true);
+    // get snapshot of readers fifo buffer, effectively consuming the buffer.
+    // A previous snapshot may be passed in as 'recycled' so that its buffer is reused when it is
+    // large enough, which avoids an allocation per call for periodic readers.
+    std::unique_ptr<Snapshot> getSnapshot(bool flush = true,
+                                          std::unique_ptr<Snapshot> recycled = nullptr);
     bool     isIMemory(const sp<IMemory>& iMemory) const;
     const std::string &name() const { return mName; }
 
@@ -84,8 +87,6 @@ private:
 // This is raw data. No analysis has been done on it
 class Snapshot {
 public:
-    ~Snapshot() { delete[] mData; }
-
     // amount of data lost (given by audio_utils_fifo_reader)
     size_t lost() const { return mLost; }
 
@@ -98,10 +99,13 @@ public:
 
 private:
     Snapshot() = default;
-    explicit Snapshot(size_t bufferSize) : mData(new uint8_t[bufferSize]) {}
-    friend std::unique_ptr<Snapshot> Reader::getSnapshot(bool flush);
+    explicit Snapshot(size_t bufferSize)
+        : mData(new uint8_t[bufferSize]), mCapacity(bufferSize) {}
+    friend std::unique_ptr<Snapshot> Reader::getSnapshot(bool flush,
+                                                         std::unique_ptr<Snapshot> recycled);
 
-    uint8_t * const       mData = nullptr;
+    std::unique_ptr<uint8_t[]> mData;
+    size_t                mCapacity = 0;
     size_t                mLost = 0;
     EntryIterator         mBegin;
     EntryIterator         mEnd;
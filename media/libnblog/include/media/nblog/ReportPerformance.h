@@ -35,6 +35,15 @@ void dumpPlots(int fd, const std::map<int, PerformanceData>& threadDataMap);
 // Dumps snapshots at important events in the past.
 void dumpRetro(int fd, const std::map<int, PerformanceData>& threadDataMap);
 
+// Dumps performance data in a compact little-endian binary format for offline tools.
+// Histograms are written as raw bin counts, so no text is formatted or parsed on either side.
+// Layout: "NBPD", uint32 version, uint32 thread count, then per thread:
+//   int32 id, int32 type, uint64 frameCount, uint32 sampleRate,
+//   int64 underruns, int64 overruns, int64 activeNs, int64 durationNs,
+//   and for each of the work, latency and warmup histograms:
+//   double binSize, double low, uint32 numBins, uint64 counts[numBins + 2].
+void dumpBinary(int fd, const std::map<int, PerformanceData>& threadDataMap);
+
 // Send one thread's data to media metrics, if the performance data is nontrivial (i.e. not
 // all zero values). Return true if data was sent, false if there is nothing to write
 // or an error occurred while writing.
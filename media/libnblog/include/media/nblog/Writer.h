@@ -41,6 +41,8 @@ struct Shared;
 
 // Writer is thread-safe with respect to Reader, but not with respect to multiple threads
 // calling Writer methods.  If you need multi-thread safety for writing, use LockedWriter.
+// For real-time or high-rate logging, prefer one Writer per thread instead: each Writer is a
+// lock-free single-producer FIFO, and the MergeReader combines the per-thread logs.
 class Writer : public RefBase {
 public:
     Writer() = default;         // dummy nop implementation without shared memory
@@ -20,13 +20,16 @@
 #include "include/FrameDecoder.h"
 #include "include/FrameCaptureLayer.h"
 #include "include/HevcUtils.h"
+#include <algorithm>
 #include <binder/MemoryBase.h>
 #include <binder/MemoryHeapBase.h>
+#include <cutils/properties.h>
 #include <gui/Surface.h>
 #include <inttypes.h>
 #include <mediadrm/ICrypto.h>
 #include <media/IMediaSource.h>
 #include <media/MediaCodecBuffer.h>
+#include <media/MediaCodecInfo.h>
 #include <media/stagefright/foundation/avc_utils.h>
 #include <media/stagefright/foundation/ADebug.h>
 #include <media/stagefright/foundation/AMessage.h>
@@ -36,6 +39,7 @@
 #include <media/stagefright/MediaBuffer.h>
 #include <media/stagefright/MediaCodec.h>
 #include <media/stagefright/MediaCodecConstants.h>
+#include <media/stagefright/MediaCodecList.h>
 #include <media/stagefright/MediaDefs.h>
 #include <media/stagefright/MediaErrors.h>
 #include <media/stagefright/Utils.h>
@@ -48,6 +52,9 @@ namespace android {
 static const int64_t kBufferTimeOutUs = 10000LL; // 10 msec
 static const size_t kRetryCount = 100; // must be >0
 static const int64_t kDefaultSampleDurationUs = 33333LL; // 33ms
+// Grid tiles are decoded on one instance unless media.stagefright.image.max-tile-decoders
+// opts in to more, pending measurements of the latency and codec resource cost.
+static const int32_t kDefaultMaxTileDecoders = 1;
 
 sp<IMemory> allocVideoFrame(const sp<MetaData>& trackMeta,
         int32_t width, int32_t height, int32_t tileWidth, int32_t tileHeight,
@@ -282,17 +289,51 @@ FrameDecoder::FrameDecoder(
       mSource(source),
       mDstFormat(OMX_COLOR_Format16bitRGB565),
       mDstBpp(2),
+      mNextInputDecoder(0),
       mHaveMoreInputs(true),
       mFirstSample(true) {
 }
 
 FrameDecoder::~FrameDecoder() {
-    if (mDecoder != NULL) {
-        mDecoder->release();
+    if (!mDecoders.empty()) {
+        for (const sp<MediaCodec> &decoder : mDecoders) {
+            decoder->release();
+        }
         mSource->stop();
     }
 }
 
+// Returns the number of instances of |componentName| that may run at the same time for
+// |mime| as advertised by the codec list, or SIZE_MAX if it doesn't say.
+static size_t getMaxConcurrentInstances(const AString &componentName, const char *mime) {
+    const sp<IMediaCodecList> mcl = MediaCodecList::getInstance();
+    if (mcl == NULL || mime == NULL) {
+        return SIZE_MAX;
+    }
+    ssize_t codecIdx = mcl->findCodecByName(componentName.c_str());
+    if (codecIdx < 0) {
+        return SIZE_MAX;
+    }
+    const sp<MediaCodecInfo> info = mcl->getCodecInfo(codecIdx);
+    if (info == NULL) {
+        return SIZE_MAX;
+    }
+    const sp<MediaCodecInfo::Capabilities> caps = info->getCapabilitiesFor(mime);
+    if (caps == NULL) {
+        return SIZE_MAX;
+    }
+    // codec list limits are usually kept as strings
+    const sp<AMessage> details = caps->getDetails();
+    int32_t maxInstances;
+    AString maxInstancesStr;
+    if (details->findString("max-concurrent-instances", &maxInstancesStr)) {
+        maxInstances = atoi(maxInstancesStr.c_str());
+    } else if (!details->findInt32("max-concurrent-instances", &maxInstances)) {
+        return SIZE_MAX;
+    }
+    return maxInstances > 0 ? maxInstances : 1;
+}
+
 bool isHDR(const sp<AMessage> &format) {
     uint32_t standard, transfer;
     if (!format->findInt32("color-standard", (int32_t*)&standard)) {
@@ -320,40 +361,98 @@ status_t FrameDecoder::init(
         return ERROR_UNSUPPORTED;
     }
 
+    // Surface output is only supported with a single decoder.
+    size_t numDecoders = (mSurface == NULL) ? onGetDecoderCount() : 1;
+    if (numDecoders > 1) {
+        AString mime;
+        videoFormat->findString("mime", &mime);
+        numDecoders = std::min(
+                numDecoders, getMaxConcurrentInstances(mComponentName, mime.c_str()));
+    }
+
+    sp<MediaCodec> decoder;
+    status_t err = createDecoder(videoFormat, mSurface, &decoder);
+    if (err != OK) {
+        return err;
+    }
+
+    err = mSource->start();
+    if (err != OK) {
+        ALOGW("source failed to start: %d (%s)", err, asString(err));
+        decoder->release();
+        return err;
+    }
+    mDecoders.push_back(decoder);
+
+    // Additional decoders only speed things up, carry on with fewer if the codec
+    // runs out of instances.
+    while (mDecoders.size() < numDecoders
+            && createDecoder(videoFormat->dup(), mSurface, &decoder) == OK) {
+        mDecoders.push_back(decoder);
+    }
+    mOutputFormats.resize(mDecoders.size());
+    ALOGV("using %zu decoder(s) of %zu requested", mDecoders.size(), numDecoders);
+
+    return OK;
+}
+
+status_t FrameDecoder::createDecoder(
+        const sp<AMessage> &videoFormat, const sp<Surface> &surface, sp<MediaCodec> *decoder) {
     status_t err;
     sp<ALooper> looper = new ALooper;
     looper->start();
-    sp<MediaCodec> decoder = MediaCodec::CreateByComponentName(
-            looper, mComponentName, &err);
-    if (decoder.get() == NULL || err != OK) {
+    *decoder = MediaCodec::CreateByComponentName(looper, mComponentName, &err);
+    if (decoder->get() == NULL || err != OK) {
         ALOGW("Failed to instantiate decoder [%s]", mComponentName.c_str());
-        return (decoder.get() == NULL) ? NO_MEMORY : err;
+        return (decoder->get() == NULL) ? NO_MEMORY : err;
     }
 
-    err = decoder->configure(
-            videoFormat, mSurface, NULL /* crypto */, 0 /* flags */);
+    err = (*decoder)->configure(
+            videoFormat, surface, NULL /* crypto */, 0 /* flags */);
     if (err != OK) {
         ALOGW("configure returned error %d (%s)", err, asString(err));
-        decoder->release();
+        (*decoder)->release();
         return err;
     }
 
-    err = decoder->start();
+    err = (*decoder)->start();
     if (err != OK) {
         ALOGW("start returned error %d (%s)", err, asString(err));
-        decoder->release();
+        (*decoder)->release();
         return err;
     }
+    return OK;
+}
 
-    err = mSource->start();
-    if (err != OK) {
-        ALOGW("source failed to start: %d (%s)", err, asString(err));
-        decoder->release();
-        return err;
+void FrameDecoder::signalEosToOtherDecoders(size_t decoderIndex) {
+    // Codecs may hold outputs back until EOS, so every decoder must get one.
+    mEosPending.assign(mDecoders.size(), true);
+    mEosPending[decoderIndex] = false;
+}
+
+void FrameDecoder::queuePendingEos() {
+    for (size_t i = 0; i < mEosPending.size(); i++) {
+        size_t index;
+        if (mEosPending[i] && mDecoders[i]->dequeueInputBuffer(&index, 0) == OK) {
+            (void)mDecoders[i]->queueInputBuffer(
+                    index, 0, 0, 0, MediaCodec::BUFFER_FLAG_EOS);
+            mEosPending[i] = false;
+        }
     }
-    mDecoder = decoder;
+}
 
-    return OK;
+status_t FrameDecoder::dequeueInputBuffer(size_t *decoderIndex, size_t *index) {
+    // Spread the inputs over the decoders in turn, skipping those that are full.
+    status_t err = OK;
+    for (size_t i = 0; i < mDecoders.size(); i++) {
+        *decoderIndex = (mNextInputDecoder + i) % mDecoders.size();
+        err = mDecoders[*decoderIndex]->dequeueInputBuffer(index, 0);
+        if (err == OK) {
+            mNextInputDecoder = (*decoderIndex + 1) % mDecoders.size();
+            return OK;
+        }
+    }
+    return err;
 }
 
 sp<IMemory> FrameDecoder::extractFrame(FrameRect *rect) {
@@ -373,20 +472,21 @@ status_t FrameDecoder::extractInternal() {
     status_t err = OK;
     bool done = false;
     size_t retriesLeft = kRetryCount;
-    if (!mDecoder) {
+    if (mDecoders.empty()) {
         ALOGE("decoder is not initialized");
         return NO_INIT;
     }
     do {
         size_t index;
+        size_t decoderIndex;
         int64_t ptsUs = 0LL;
         uint32_t flags = 0;
 
         // Queue as many inputs as we possibly can, then block on dequeuing
         // outputs. After getting each output, come back and queue the inputs
-        // again to keep the decoder busy.
+        // again to keep the decoders busy.
         while (mHaveMoreInputs) {
-            err = mDecoder->dequeueInputBuffer(&index, 0);
+            err = dequeueInputBuffer(&decoderIndex, &index);
             if (err != OK) {
                 ALOGV("Timed out waiting for input");
                 if (retriesLeft) {
@@ -394,8 +494,9 @@ status_t FrameDecoder::extractInternal() {
                 }
                 break;
             }
+            const sp<MediaCodec> &decoder = mDecoders[decoderIndex];
             sp<MediaCodecBuffer> codecBuffer;
-            err = mDecoder->getInputBuffer(index, &codecBuffer);
+            err = decoder->getInputBuffer(index, &codecBuffer);
             if (err != OK) {
                 ALOGE("failed to get input buffer %zu", index);
                 break;
@@ -408,8 +509,9 @@ status_t FrameDecoder::extractInternal() {
             if (err != OK) {
                 mHaveMoreInputs = false;
                 if (!mFirstSample && err == ERROR_END_OF_STREAM) {
-                    (void)mDecoder->queueInputBuffer(
+                    (void)decoder->queueInputBuffer(
                             index, 0, 0, 0, MediaCodec::BUFFER_FLAG_EOS);
+                    signalEosToOtherDecoders(decoderIndex);
                     err = OK;
                 } else {
                     ALOGW("Input Error: err=%d", err);
@@ -440,23 +542,31 @@ status_t FrameDecoder::extractInternal() {
                 ALOGV("QueueInput: size=%zu ts=%" PRId64 " us flags=%x",
                         codecBuffer->size(), ptsUs, flags);
 
-                err = mDecoder->queueInputBuffer(
+                err = decoder->queueInputBuffer(
                         index,
                         codecBuffer->offset(),
                         codecBuffer->size(),
                         ptsUs,
                         flags);
+                if (err == OK && mDecoders.size() > 1) {
+                    mPendingOutputs.push_back(decoderIndex);
+                }
 
                 if (flags & MediaCodec::BUFFER_FLAG_EOS) {
                     mHaveMoreInputs = false;
+                    signalEosToOtherDecoders(decoderIndex);
                 }
             }
         }
+        queuePendingEos();
 
         while (err == OK) {
             size_t offset, size;
-            // wait for a decoded buffer
-            err = mDecoder->dequeueOutputBuffer(
+            // Wait for a decoded buffer. With several decoders, wait on the one
+            // holding the oldest input, so that outputs come in input order.
+            decoderIndex = mPendingOutputs.empty() ? 0 : mPendingOutputs.front();
+            const sp<MediaCodec> &decoder = mDecoders[decoderIndex];
+            err = decoder->dequeueOutputBuffer(
                     &index,
                     &offset,
                     &size,
@@ -466,7 +576,7 @@ status_t FrameDecoder::extractInternal() {
 
             if (err == INFO_FORMAT_CHANGED) {
                 ALOGV("Received format change");
-                err = mDecoder->getOutputFormat(&mOutputFormat);
+                err = decoder->getOutputFormat(&mOutputFormats[decoderIndex]);
             } else if (err == INFO_OUTPUT_BUFFERS_CHANGED) {
                 ALOGV("Output buffers changed");
                 err = OK;
@@ -474,22 +584,36 @@ status_t FrameDecoder::extractInternal() {
                 if (err == -EAGAIN /* INFO_TRY_AGAIN_LATER */ && --retriesLeft > 0) {
                     ALOGV("Timed-out waiting for output.. retries left = %zu", retriesLeft);
                     err = OK;
+                } else if (err == OK && mDecoders.size() > 1
+                        && (flags & MediaCodec::BUFFER_FLAG_EOS) && size == 0) {
+                    // The decoder is drained, any input it still owes an output for
+                    // was dropped.
+                    ALOGV("Decoder %zu reached EOS", decoderIndex);
+                    decoder->releaseOutputBuffer(index);
+                    mPendingOutputs.erase(
+                            std::remove(mPendingOutputs.begin(), mPendingOutputs.end(),
+                                        decoderIndex),
+                            mPendingOutputs.end());
                 } else if (err == OK) {
                     // If we're seeking with CLOSEST option and obtained a valid targetTimeUs
                     // from the extractor, decode to the specified frame. Otherwise we're done.
                     ALOGV("Received an output buffer, timeUs=%lld", (long long)ptsUs);
+                    if (!mPendingOutputs.empty()) {
+                        mPendingOutputs.pop_front();
+                    }
+                    const sp<AMessage> &outputFormat = mOutputFormats[decoderIndex];
                     sp<MediaCodecBuffer> videoFrameBuffer;
-                    err = mDecoder->getOutputBuffer(index, &videoFrameBuffer);
+                    err = decoder->getOutputBuffer(index, &videoFrameBuffer);
                     if (err != OK) {
                         ALOGE("failed to get output buffer %zu", index);
                         break;
                     }
                     if (mSurface != nullptr) {
-                        mDecoder->renderOutputBufferAndRelease(index);
-                        err = onOutputReceived(videoFrameBuffer, mOutputFormat, ptsUs, &done);
+                        decoder->renderOutputBufferAndRelease(index);
+                        err = onOutputReceived(videoFrameBuffer, outputFormat, ptsUs, &done);
                     } else {
-                        err = onOutputReceived(videoFrameBuffer, mOutputFormat, ptsUs, &done);
-                        mDecoder->releaseOutputBuffer(index);
+                        err = onOutputReceived(videoFrameBuffer, outputFormat, ptsUs, &done);
+                        decoder->releaseOutputBuffer(index);
                     }
                 } else {
                     ALOGW("Received error %d (%s) instead of output", err, asString(err));
@@ -905,6 +1029,15 @@ sp<AMessage> MediaImageDecoder::onGetFormatAndSeekOptions(
     return videoFormat;
 }
 
+size_t MediaImageDecoder::onGetDecoderCount() {
+    // Grid tiles are coded independently of each other, so they can be decoded
+    // in parallel by several decoders, each converting its tiles straight into
+    // the frame.
+    int32_t maxTileDecoders = property_get_int32(
+            "media.stagefright.image.max-tile-decoders", kDefaultMaxTileDecoders);
+    return std::max(1, std::min(maxTileDecoders, mGridRows * mGridCols));
+}
+
 status_t MediaImageDecoder::onExtractRect(FrameRect *rect) {
     // TODO:
     // This callback is for verifying whether we can decode the rect,
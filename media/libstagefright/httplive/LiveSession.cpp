@@ -54,54 +54,33 @@ const int64_t LiveSession::kResumeThresholdUs = 100000LL;
 // default buffer underflow mark
 static const int kUnderflowMarkMs = 1000;  // 1 second
 
-struct LiveSession::BandwidthEstimator : public RefBase {
-    BandwidthEstimator();
-
-    void addBandwidthMeasurement(size_t numBytes, int64_t delayUs);
-    bool estimateBandwidth(
-            int32_t *bandwidth,
-            bool *isStable = NULL,
-            int32_t *shortTermBps = NULL);
-
-private:
-    // Bandwidth estimation parameters
-    static const int32_t kShortTermBandwidthItems = 3;
-    static const int32_t kMinBandwidthHistoryItems = 20;
-    static const int64_t kMinBandwidthHistoryWindowUs = 5000000LL; // 5 sec
-    static const int64_t kMaxBandwidthHistoryWindowUs = 30000000LL; // 30 sec
-    static const int64_t kMaxBandwidthHistoryAgeUs = 60000000LL; // 60 sec
-
-    struct BandwidthEntry {
-        int64_t mTimestampUs;
-        int64_t mDelayUs;
-        size_t mNumBytes;
-    };
-
-    Mutex mLock;
-    List<BandwidthEntry> mBandwidthHistory;
-    List<int32_t> mPrevEstimates;
-    int32_t mShortTermEstimate;
-    bool mHasNewSample;
-    bool mIsStable;
-    int64_t mTotalTransferTimeUs;
-    size_t mTotalTransferBytes;
-
-    DISALLOW_EVIL_CONSTRUCTORS(BandwidthEstimator);
-};
-
 LiveSession::BandwidthEstimator::BandwidthEstimator() :
     mShortTermEstimate(0),
     mHasNewSample(false),
     mIsStable(true),
     mTotalTransferTimeUs(0),
-    mTotalTransferBytes(0) {
+    mTotalTransferBytes(0),
+    mLastTransferEndUs(0) {
 }
 
 void LiveSession::BandwidthEstimator::addBandwidthMeasurement(
         size_t numBytes, int64_t delayUs) {
+    addBandwidthMeasurement(numBytes, delayUs, ALooper::GetNowUs());
+}
+
+void LiveSession::BandwidthEstimator::addBandwidthMeasurement(
+        size_t numBytes, int64_t delayUs, int64_t nowUs) {
     AutoMutex autoLock(mLock);
 
-    int64_t nowUs = ALooper::GetNowUs();
+    // Transfers on concurrent connections (other fetchers, segment prefetch)
+    // overlap in time. Only count the part of this one that isn't already
+    // covered, so the estimate is the aggregate throughput of the link rather
+    // than each connection's share of it.
+    if (nowUs - delayUs < mLastTransferEndUs) {
+        delayUs = nowUs - mLastTransferEndUs;
+    }
+    mLastTransferEndUs = nowUs;
+
     BandwidthEntry entry;
     entry.mTimestampUs = nowUs;
     entry.mDelayUs = delayUs;
@@ -141,7 +120,7 @@ bool LiveSession::BandwidthEstimator::estimateBandwidth(
         int32_t *bandwidthBps, bool *isStable, int32_t *shortTermBps) {
     AutoMutex autoLock(mLock);
 
-    if (mBandwidthHistory.size() < 2) {
+    if (mBandwidthHistory.size() < 2 || mTotalTransferTimeUs <= 0) {
         return false;
     }
 
@@ -22,6 +22,8 @@
 #include <media/stagefright/foundation/AHandler.h>
 #include <media/mediaplayer.h>
 
+#include <utils/List.h>
+#include <utils/Mutex.h>
 #include <utils/String8.h>
 
 #include <mpeg2ts/ATSParser.h>
@@ -122,6 +124,8 @@ protected:
 
 private:
     friend struct PlaylistFetcher;
+    friend struct SegmentPrefetcher;
+    friend struct BandwidthEstimatorTest;
 
     enum {
         kWhatConnect                    = 'conn',
@@ -312,6 +316,45 @@ private:
     DISALLOW_EVIL_CONSTRUCTORS(LiveSession);
 };
 
+struct LiveSession::BandwidthEstimator : public RefBase {
+    BandwidthEstimator();
+
+    void addBandwidthMeasurement(size_t numBytes, int64_t delayUs);
+    // As above, for a transfer that ended at nowUs. Transfers must be added in
+    // the order they ended.
+    void addBandwidthMeasurement(size_t numBytes, int64_t delayUs, int64_t nowUs);
+    bool estimateBandwidth(
+            int32_t *bandwidth,
+            bool *isStable = NULL,
+            int32_t *shortTermBps = NULL);
+
+private:
+    // Bandwidth estimation parameters
+    static const int32_t kShortTermBandwidthItems = 3;
+    static const int32_t kMinBandwidthHistoryItems = 20;
+    static const int64_t kMinBandwidthHistoryWindowUs = 5000000LL; // 5 sec
+    static const int64_t kMaxBandwidthHistoryWindowUs = 30000000LL; // 30 sec
+    static const int64_t kMaxBandwidthHistoryAgeUs = 60000000LL; // 60 sec
+
+    struct BandwidthEntry {
+        int64_t mTimestampUs;
+        int64_t mDelayUs;
+        size_t mNumBytes;
+    };
+
+    Mutex mLock;
+    List<BandwidthEntry> mBandwidthHistory;
+    List<int32_t> mPrevEstimates;
+    int32_t mShortTermEstimate;
+    bool mHasNewSample;
+    bool mIsStable;
+    int64_t mTotalTransferTimeUs;
+    size_t mTotalTransferBytes;
+    int64_t mLastTransferEndUs;
+
+    DISALLOW_EVIL_CONSTRUCTORS(BandwidthEstimator);
+};
+
 }  // namespace android
 
 #endif  // LIVE_SESSION_H_
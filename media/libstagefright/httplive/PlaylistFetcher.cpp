@@ -24,10 +24,12 @@
 #include "HTTPDownloader.h"
 #include "LiveSession.h"
 #include "M3UParser.h"
+#include "SegmentPrefetcher.h"
 #include <ID3.h>
 #include <mpeg2ts/AnotherPacketSource.h>
 #include <mpeg2ts/HlsSampleDecryptor.h>
 
+#include <cutils/properties.h>
 #include <datasource/DataURISource.h>
 #include <media/stagefright/foundation/ABitReader.h>
 #include <media/stagefright/foundation/ABuffer.h>
@@ -55,6 +57,8 @@ const int64_t PlaylistFetcher::kMinBufferedDurationUs = 30000000LL;
 const int64_t PlaylistFetcher::kMaxMonitorDelayUs = 3000000LL;
 // LCM of 188 (size of a TS packet) & 1k works well
 const int32_t PlaylistFetcher::kDownloadBlockSize = 47 * 1024;
+// Larger segments are left to the fetcher's own, incremental, download.
+const size_t PlaylistFetcher::kMaxPrefetchBytes = 16 * 1024 * 1024;
 
 struct PlaylistFetcher::DownloadState : public RefBase {
     DownloadState();
@@ -181,11 +185,25 @@ PlaylistFetcher::PlaylistFetcher(
     memset(mPlaylistHash, 0, sizeof(mPlaylistHash));
     mHTTPDownloader = mSession->getHTTPDownloader();
 
+    char value[PROPERTY_VALUE_MAX];
+    if (property_get("media.httplive.prefetch-segments", value, "1")) {
+        char *end;
+        long numSegments = strtol(value, &end, 10);
+        if (end > value && *end == '\0' && numSegments > 0 && numSegments <= 8) {
+            for (long i = 0; i < numSegments; ++i) {
+                mPrefetchers.push(new SegmentPrefetcher(mSession, kMaxPrefetchBytes));
+            }
+        }
+    }
+
     memset(mKeyData, 0, sizeof(mKeyData));
     memset(mAESInitVec, 0, sizeof(mAESInitVec));
 }
 
 PlaylistFetcher::~PlaylistFetcher() {
+    for (size_t i = 0; i < mPrefetchers.size(); ++i) {
+        mPrefetchers[i]->stop();
+    }
 }
 
 int32_t PlaylistFetcher::getFetcherID() const {
@@ -526,6 +544,12 @@ void PlaylistFetcher::setStoppingThreshold(float thresholdRatio, bool disconnect
     if (disconnect) {
         mHTTPDownloader->disconnect();
     }
+    if (thresholdRatio >= 0.0f) {
+        // A prefetched segment is consumed as a single block, which the threshold
+        // can't stop in. Drop the prefetches, this also wakes up onDownloadNext()
+        // if it's waiting for one, so that it downloads the segment block-wise.
+        cancelPrefetch();
+    }
 }
 
 void PlaylistFetcher::resetStoppingThreshold(bool disconnect) {
@@ -779,6 +803,7 @@ status_t PlaylistFetcher::onStart(const sp<AMessage> &msg) {
         mSeqNumber = -1;
         mTimeChangeSignaled = false;
         mDownloadState->resetState();
+        cancelPrefetch();
     }
 
     postMonitorQueue();
@@ -808,6 +833,7 @@ void PlaylistFetcher::onStop(const sp<AMessage> &msg) {
     mDownloadState->resetState();
     mPacketSources.clear();
     mStreamTypeMask = 0;
+    cancelPrefetch();
 
     resetStoppingThreshold(true /* disconnect */);
 }
@@ -1364,14 +1390,33 @@ void PlaylistFetcher::onDownloadNext() {
         range_length = -1;
     }
 
+    sp<ABuffer> prefetched;
+    if (connectHTTP) {
+        prefetched = takePrefetchedSegment(uri, itemMeta);
+        prefetchSegments(firstSeqNumberInPlaylist, lastSeqNumberInPlaylist);
+    }
+
     // block-wise download
     bool shouldPause = false;
     ssize_t bytesRead;
     do {
         int64_t startUs = ALooper::GetNowUs();
-        bytesRead = mHTTPDownloader->fetchBlock(
-                uri.c_str(), &buffer, range_offset, range_length, kDownloadBlockSize,
-                NULL /* actualURL */, connectHTTP);
+        int32_t isPrefetched = 0;
+        if (prefetched != NULL) {
+            // Downloaded (and measured) by a prefetcher: process it as a single block.
+            buffer = prefetched;
+            prefetched.clear();
+            buffer->meta()->setInt32("prefetched", 1);
+            bytesRead = buffer->size();
+            isPrefetched = 1;
+        } else if (buffer != NULL && buffer->meta()->findInt32("prefetched", &isPrefetched)) {
+            // resuming after a pause, the whole segment was already processed
+            bytesRead = 0;
+        } else {
+            bytesRead = mHTTPDownloader->fetchBlock(
+                    uri.c_str(), &buffer, range_offset, range_length, kDownloadBlockSize,
+                    NULL /* actualURL */, connectHTTP);
+        }
         int64_t delayUs = ALooper::GetNowUs() - startUs;
 
         if (bytesRead == ERROR_NOT_CONNECTED) {
@@ -1387,7 +1432,7 @@ void PlaylistFetcher::onDownloadNext() {
         // add sample for bandwidth estimation, excluding samples from subtitles (as
         // its too small), or during startup/resumeUntil (when we could have more than
         // one connection open which affects bandwidth)
-        if (!mStartup && mStopParams == NULL && bytesRead > 0
+        if (!mStartup && mStopParams == NULL && bytesRead > 0 && !isPrefetched
                 && (mStreamTypeMask
                         & (LiveSession::STREAMTYPE_AUDIO
                         | LiveSession::STREAMTYPE_VIDEO))) {
@@ -1555,6 +1600,80 @@ void PlaylistFetcher::onDownloadNext() {
     }
 }
 
+// Starts downloading the segments after mSeqNumber that no prefetcher holds yet.
+// Only done during steady playback: at startup and while switching variants the
+// fetcher may stop anywhere within the current segment.
+void PlaylistFetcher::prefetchSegments(
+        int32_t firstSeqNumberInPlaylist, int32_t lastSeqNumberInPlaylist) {
+    if (mPrefetchers.isEmpty() || mStartup || mStopParams != NULL
+            || getStoppingThreshold() >= 0.0f
+            || !(mStreamTypeMask
+                    & (LiveSession::STREAMTYPE_AUDIO | LiveSession::STREAMTYPE_VIDEO))) {
+        return;
+    }
+
+    int32_t lastSeqNumber = mSeqNumber + (int32_t)mPrefetchers.size();
+    if (lastSeqNumber > lastSeqNumberInPlaylist) {
+        lastSeqNumber = lastSeqNumberInPlaylist;
+    }
+    for (int32_t seqNumber = mSeqNumber + 1; seqNumber <= lastSeqNumber; ++seqNumber) {
+        sp<SegmentPrefetcher> idle;
+        bool held = false;
+        for (size_t i = 0; i < mPrefetchers.size(); ++i) {
+            int32_t prefetcherSeqNumber = mPrefetchers[i]->getSeqNumber();
+            if (prefetcherSeqNumber == seqNumber) {
+                held = true;
+                break;
+            }
+            if (prefetcherSeqNumber <= mSeqNumber || prefetcherSeqNumber > lastSeqNumber) {
+                idle = mPrefetchers[i];
+            }
+        }
+        if (held || idle == NULL) {
+            continue;
+        }
+
+        AString uri;
+        sp<AMessage> itemMeta;
+        if (!mPlaylist->itemAt(seqNumber - firstSeqNumberInPlaylist, &uri, &itemMeta)) {
+            break;
+        }
+        int64_t rangeOffset, rangeLength;
+        if (!itemMeta->findInt64("range-offset", &rangeOffset)
+                || !itemMeta->findInt64("range-length", &rangeLength)) {
+            rangeOffset = 0;
+            rangeLength = -1;
+        }
+        FLOGV("prefetching segment %d", seqNumber);
+        idle->fetchAsync(seqNumber, uri, rangeOffset, rangeLength);
+    }
+}
+
+// Returns the current segment if a prefetcher downloaded it, or NULL.
+sp<ABuffer> PlaylistFetcher::takePrefetchedSegment(
+        const AString &uri, const sp<AMessage> &itemMeta) {
+    int64_t rangeOffset, rangeLength;
+    if (!itemMeta->findInt64("range-offset", &rangeOffset)
+            || !itemMeta->findInt64("range-length", &rangeLength)) {
+        rangeOffset = 0;
+        rangeLength = -1;
+    }
+    for (size_t i = 0; i < mPrefetchers.size(); ++i) {
+        if (mPrefetchers[i]->getSeqNumber() == mSeqNumber) {
+            sp<ABuffer> buffer = mPrefetchers[i]->take(mSeqNumber, uri, rangeOffset, rangeLength);
+            FLOGV("segment %d %s prefetched", mSeqNumber, buffer != NULL ? "was" : "was not");
+            return buffer;
+        }
+    }
+    return NULL;
+}
+
+void PlaylistFetcher::cancelPrefetch() {
+    for (size_t i = 0; i < mPrefetchers.size(); ++i) {
+        mPrefetchers[i]->cancel();
+    }
+}
+
 /*
  * returns true if we need to adjust mSeqNumber
  */
@@ -32,6 +32,7 @@ class DataSource;
 struct HTTPBase;
 struct LiveDataSource;
 struct M3UParser;
+struct SegmentPrefetcher;
 class String8;
 
 struct PlaylistFetcher : public AHandler {
@@ -109,6 +110,7 @@ private:
 
     static const int64_t kMaxMonitorDelayUs;
     static const int32_t kNumSkipFrames;
+    static const size_t kMaxPrefetchBytes;
 
     static bool bufferStartsWithTsSyncByte(const sp<ABuffer>& buffer);
     static bool bufferStartsWithWebVTTMagicSequence(const sp<ABuffer>& buffer);
@@ -187,6 +189,11 @@ private:
 
     sp<DownloadState> mDownloadState;
 
+    // Download the segments following the current one, one each; sized from
+    // media.httplive.prefetch-segments at construction and not changed after, as
+    // cancelPrefetch() may be called from other threads.
+    Vector<sp<SegmentPrefetcher> > mPrefetchers;
+
     bool mHasMetadata;
 
     // Set first to true if decrypting the first segment of a playlist segment. When
@@ -209,6 +216,11 @@ private:
     float getStoppingThreshold();
     bool shouldPauseDownload();
 
+    void prefetchSegments(int32_t firstSeqNumberInPlaylist, int32_t lastSeqNumberInPlaylist);
+    sp<ABuffer> takePrefetchedSegment(
+            const AString &uri, const sp<AMessage> &itemMeta);
+    void cancelPrefetch();
+
     int64_t delayUsToRefreshPlaylist() const;
     status_t refreshPlaylist();
 
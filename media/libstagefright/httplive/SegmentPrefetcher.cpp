@@ -0,0 +1,200 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "SegmentPrefetcher"
+#include <utils/Log.h>
+
+#include "SegmentPrefetcher.h"
+#include "HTTPDownloader.h"
+#include "LiveSession.h"
+
+#include <media/stagefright/foundation/ABuffer.h>
+#include <media/stagefright/foundation/ADebug.h>
+#include <media/stagefright/foundation/ALooper.h>
+#include <media/stagefright/foundation/AMessage.h>
+
+namespace android {
+
+// Same block size as PlaylistFetcher, so bandwidth samples are comparable.
+static const uint32_t kDownloadBlockSize = 47 * 1024;
+
+SegmentPrefetcher::SegmentPrefetcher(const sp<LiveSession> &session, size_t maxBytes)
+    : mSession(session),
+      mHTTPDownloader(session->getHTTPDownloader()),
+      mMaxBytes(maxBytes),
+      mState(IDLE),
+      mGeneration(0),
+      mSeqNumber(-1),
+      mRangeOffset(0),
+      mRangeLength(-1) {
+}
+
+SegmentPrefetcher::~SegmentPrefetcher() {
+}
+
+void SegmentPrefetcher::stop() {
+    cancel();
+    if (mLooper != NULL) {
+        mLooper->unregisterHandler(id());
+        mLooper->stop();
+        mLooper.clear();
+    }
+}
+
+void SegmentPrefetcher::fetchAsync(
+        int32_t seqNumber, const AString &uri,
+        int64_t rangeOffset, int64_t rangeLength) {
+    if (mLooper == NULL) {
+        mLooper = new ALooper;
+        mLooper->setName("segment prefetcher");
+        mLooper->start();
+        mLooper->registerHandler(this);
+    }
+
+    int32_t generation;
+    {
+        Mutex::Autolock autoLock(mLock);
+        resetLocked();
+        generation = mGeneration;
+        mState = FETCHING;
+        mSeqNumber = seqNumber;
+        mURI = uri;
+        mRangeOffset = rangeOffset;
+        mRangeLength = rangeLength;
+    }
+    // abort the previous download, if any; onFetch() reconnects
+    mHTTPDownloader->disconnect();
+
+    sp<AMessage> msg = new AMessage(kWhatFetch, this);
+    msg->setInt32("generation", generation);
+    msg->post();
+}
+
+void SegmentPrefetcher::cancel() {
+    {
+        Mutex::Autolock autoLock(mLock);
+        resetLocked();
+    }
+    mHTTPDownloader->disconnect();
+}
+
+void SegmentPrefetcher::resetLocked() {
+    ++mGeneration;
+    mState = IDLE;
+    mSeqNumber = -1;
+    mBuffer.clear();
+    mCondition.broadcast();
+}
+
+int32_t SegmentPrefetcher::getSeqNumber() {
+    Mutex::Autolock autoLock(mLock);
+    return mSeqNumber;
+}
+
+sp<ABuffer> SegmentPrefetcher::take(
+        int32_t seqNumber, const AString &uri,
+        int64_t rangeOffset, int64_t rangeLength) {
+    Mutex::Autolock autoLock(mLock);
+
+    const int32_t generation = mGeneration;
+    if (mSeqNumber != seqNumber || mURI != uri
+            || mRangeOffset != rangeOffset || mRangeLength != rangeLength) {
+        return NULL;
+    }
+    while (mState == FETCHING && mGeneration == generation) {
+        mCondition.wait(mLock);
+    }
+    if (mGeneration != generation) {
+        // cancelled while waiting
+        return NULL;
+    }
+
+    sp<ABuffer> buffer = mBuffer;
+    resetLocked();
+    return buffer;
+}
+
+void SegmentPrefetcher::onMessageReceived(const sp<AMessage> &msg) {
+    switch (msg->what()) {
+        case kWhatFetch:
+        {
+            onFetch(msg);
+            break;
+        }
+
+        default:
+            TRESPASS();
+    }
+}
+
+void SegmentPrefetcher::onFetch(const sp<AMessage> &msg) {
+    int32_t generation;
+    CHECK(msg->findInt32("generation", &generation));
+
+    int32_t seqNumber;
+    AString uri;
+    int64_t rangeOffset, rangeLength;
+    {
+        Mutex::Autolock autoLock(mLock);
+        if (generation != mGeneration) {
+            // superseded before it started
+            return;
+        }
+        seqNumber = mSeqNumber;
+        uri = mURI;
+        rangeOffset = mRangeOffset;
+        rangeLength = mRangeLength;
+    }
+
+    mHTTPDownloader->reconnect();
+
+    sp<ABuffer> buffer;
+    bool connectHTTP = true;
+    ssize_t bytesRead;
+    do {
+        int64_t startUs = ALooper::GetNowUs();
+        bytesRead = mHTTPDownloader->fetchBlock(
+                uri.c_str(), &buffer, rangeOffset, rangeLength, kDownloadBlockSize,
+                NULL /* actualURL */, connectHTTP);
+        int64_t delayUs = ALooper::GetNowUs() - startUs;
+        connectHTTP = false;
+
+        if (bytesRead > 0) {
+            // The estimator merges overlapping transfers, so this adds to, rather
+            // than splits, the bandwidth seen by the fetcher's own connection.
+            mSession->addBandwidthMeasurement(bytesRead, delayUs);
+        }
+        if (buffer != NULL && buffer->capacity() > mMaxBytes) {
+            ALOGV("segment %d is over %zu bytes, not prefetching it", seqNumber, mMaxBytes);
+            bytesRead = ERROR_OUT_OF_RANGE;
+        }
+    } while (bytesRead > 0);
+
+    Mutex::Autolock autoLock(mLock);
+    if (generation != mGeneration) {
+        return;
+    }
+    if (bytesRead < 0) {
+        ALOGV("prefetch of segment %d failed: %zd", seqNumber, bytesRead);
+        buffer.clear();
+    }
+    mBuffer = buffer;
+    mState = DONE;
+    mCondition.broadcast();
+}
+
+}  // namespace android
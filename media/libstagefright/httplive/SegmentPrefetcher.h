@@ -0,0 +1,99 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SEGMENT_PREFETCHER_H_
+
+#define SEGMENT_PREFETCHER_H_
+
+#include <media/stagefright/foundation/ABase.h>
+#include <media/stagefright/foundation/AHandler.h>
+#include <media/stagefright/foundation/AString.h>
+#include <utils/Condition.h>
+#include <utils/Mutex.h>
+
+namespace android {
+
+struct ABuffer;
+struct ALooper;
+struct HTTPDownloader;
+struct LiveSession;
+
+// Downloads one media segment ahead of a PlaylistFetcher, on its own connection
+// and looper, so that request latency and transfer of upcoming segments overlap
+// with the segment the fetcher is working on.
+struct SegmentPrefetcher : public AHandler {
+    SegmentPrefetcher(const sp<LiveSession> &session, size_t maxBytes);
+
+    void stop();
+
+    // Starts downloading a segment, dropping whatever this prefetcher held.
+    // The looper is started on first use.
+    void fetchAsync(
+            int32_t seqNumber, const AString &uri,
+            int64_t rangeOffset, int64_t rangeLength);
+
+    // Aborts the download in progress, if any, and drops the downloaded segment.
+    void cancel();
+
+    // Sequence number of the segment held or being downloaded, or -1.
+    int32_t getSeqNumber();
+
+    // Hands over the segment if it is the one described, waiting for its download
+    // to complete. Returns NULL if this prefetcher holds another segment or if the
+    // download failed; the caller then downloads the segment itself.
+    sp<ABuffer> take(
+            int32_t seqNumber, const AString &uri,
+            int64_t rangeOffset, int64_t rangeLength);
+
+protected:
+    virtual ~SegmentPrefetcher();
+    virtual void onMessageReceived(const sp<AMessage> &msg);
+
+private:
+    enum {
+        kWhatFetch = 'ftch',
+    };
+
+    enum State {
+        IDLE,
+        FETCHING,
+        DONE,
+    };
+
+    sp<LiveSession> mSession;
+    sp<HTTPDownloader> mHTTPDownloader;
+    sp<ALooper> mLooper;
+    const size_t mMaxBytes;
+
+    Mutex mLock;
+    Condition mCondition;
+    State mState;
+    int32_t mGeneration;
+    int32_t mSeqNumber;
+    AString mURI;
+    int64_t mRangeOffset;
+    int64_t mRangeLength;
+    sp<ABuffer> mBuffer;  // NULL in DONE state if the download failed
+
+    void onFetch(const sp<AMessage> &msg);
+    void resetLocked();
+
+    DISALLOW_EVIL_CONSTRUCTORS(SegmentPrefetcher);
+};
+
+}  // namespace android
+
+#endif  // SEGMENT_PREFETCHER_H_
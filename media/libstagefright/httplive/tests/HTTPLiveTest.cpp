@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "HTTPLiveTest"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <android-base/file.h>
+#include <gtest/gtest.h>
+
+#include <LiveSession.h>
+#include <SegmentPrefetcher.h>
+#include <media/MediaHTTPConnection.h>
+#include <media/MediaHTTPService.h>
+#include <media/stagefright/MediaErrors.h>
+#include <media/stagefright/foundation/ABuffer.h>
+#include <media/stagefright/foundation/AString.h>
+
+namespace android {
+
+static const char kURIPrefix[] = "http://test.invalid/";
+
+// Serves files of a local directory as http://test.invalid/<name>, honoring Range
+// headers. Reads can be held, to observe a download in progress; a held read
+// returns once its connection is disconnected.
+struct FileHTTPService : public MediaHTTPService {
+    explicit FileHTTPService(const std::string &dir)
+        : mDir(dir), mHoldReads(false), mNumHeldReads(0) {}
+
+    sp<MediaHTTPConnection> makeHTTPConnection() override;
+
+    void holdReads() {
+        std::lock_guard<std::mutex> lock(mLock);
+        mHoldReads = true;
+    }
+
+    void releaseReads() {
+        std::lock_guard<std::mutex> lock(mLock);
+        mHoldReads = false;
+        mCondition.notify_all();
+    }
+
+    // Waits until a read is held.
+    void waitForHeldRead() {
+        std::unique_lock<std::mutex> lock(mLock);
+        mCondition.wait(lock, [this] { return mNumHeldReads > 0; });
+    }
+
+    const std::string mDir;
+
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    bool mHoldReads;
+    int mNumHeldReads;
+};
+
+struct FileHTTPConnection : public MediaHTTPConnection {
+    explicit FileHTTPConnection(const sp<FileHTTPService> &service)
+        : mService(service), mFd(-1), mRangeOffset(0), mSize(0), mDisconnected(false) {}
+
+    ~FileHTTPConnection() override {
+        closeFile();
+    }
+
+    bool connect(const char *uri, const KeyedVector<String8, String8> *headers) override {
+        closeFile();
+        if (strncmp(uri, kURIPrefix, strlen(kURIPrefix))) {
+            return false;
+        }
+        const std::string path = mService->mDir + "/" + (uri + strlen(kURIPrefix));
+        mFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (mFd < 0) {
+            return false;
+        }
+        const off64_t fileSize = lseek64(mFd, 0, SEEK_END);
+        off64_t rangeEnd = fileSize;
+        mRangeOffset = 0;
+        ssize_t index = headers != NULL ? headers->indexOfKey(String8("Range")) : -1;
+        if (index >= 0) {
+            // "bytes=<first>-[<last>]"
+            const char *range = headers->valueAt(index).c_str() + strlen("bytes=");
+            char *end;
+            mRangeOffset = strtoll(range, &end, 10);
+            if (end[1] != '\0') {
+                rangeEnd = std::min(fileSize, (off64_t)strtoll(end + 1, NULL, 10) + 1);
+            }
+        }
+        mSize = std::max((off64_t)0, rangeEnd - mRangeOffset);
+
+        std::lock_guard<std::mutex> lock(mService->mLock);
+        mDisconnected = false;
+        return true;
+    }
+
+    void disconnect() override {
+        std::lock_guard<std::mutex> lock(mService->mLock);
+        mDisconnected = true;
+        mService->mCondition.notify_all();
+    }
+
+    ssize_t readAt(off64_t offset, void *data, size_t size) override {
+        {
+            std::unique_lock<std::mutex> lock(mService->mLock);
+            if (mService->mHoldReads && !mDisconnected) {
+                ++mService->mNumHeldReads;
+                mService->mCondition.notify_all();
+                mService->mCondition.wait(lock, [this] {
+                    return !mService->mHoldReads || mDisconnected;
+                });
+                --mService->mNumHeldReads;
+            }
+            if (mDisconnected) {
+                return ERROR_IO;
+            }
+        }
+        if (offset >= mSize) {
+            return 0;
+        }
+        size = std::min(size, (size_t)(mSize - offset));
+        return pread64(mFd, data, size, mRangeOffset + offset);
+    }
+
+    off64_t getSize() override { return mSize; }
+    status_t getMIMEType(String8 *mimeType) override {
+        *mimeType = String8("application/octet-stream");
+        return OK;
+    }
+    status_t getUri(String8 *uri) override {
+        *uri = String8();
+        return OK;
+    }
+
+private:
+    void closeFile() {
+        if (mFd >= 0) {
+            close(mFd);
+            mFd = -1;
+        }
+    }
+
+    const sp<FileHTTPService> mService;
+    int mFd;
+    off64_t mRangeOffset;
+    off64_t mSize;
+    bool mDisconnected;  // guarded by the service lock
+};
+
+sp<MediaHTTPConnection> FileHTTPService::makeHTTPConnection() {
+    return new FileHTTPConnection(this);
+}
+
+class SegmentPrefetcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        mService = new FileHTTPService(mDir.path);
+        mSession = new LiveSession(NULL /* notify */, 0 /* flags */, mService);
+        mPrefetcher = new SegmentPrefetcher(mSession, kMaxBytes);
+    }
+
+    void TearDown() override {
+        mService->releaseReads();
+        mPrefetcher->stop();
+    }
+
+    // Writes a segment of the given size and returns its URI.
+    AString addSegment(const char *name, size_t size) {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = (char)(i * 7 + name[0]);
+        }
+        EXPECT_TRUE(base::WriteStringToFile(data, std::string(mDir.path) + "/" + name));
+        return AStringPrintf("%s%s", kURIPrefix, name);
+    }
+
+    std::string readSegment(const AString &uri, size_t offset = 0, size_t length = -1) {
+        std::string data;
+        EXPECT_TRUE(base::ReadFileToString(
+                std::string(mDir.path) + "/" + (uri.c_str() + strlen(kURIPrefix)), &data));
+        return data.substr(offset, length);
+    }
+
+    static std::string toString(const sp<ABuffer> &buffer) {
+        return std::string((const char *)buffer->data(), buffer->size());
+    }
+
+    static const size_t kMaxBytes = 1024 * 1024;
+    static const size_t kSegmentSize = 200 * 1024;
+
+    TemporaryDir mDir;
+    sp<FileHTTPService> mService;
+    sp<LiveSession> mSession;
+    sp<SegmentPrefetcher> mPrefetcher;
+};
+
+TEST_F(SegmentPrefetcherTest, TakeReturnsSegment) {
+    const AString uri = addSegment("seg1.ts", kSegmentSize);
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+    EXPECT_EQ(1, mPrefetcher->getSeqNumber());
+
+    sp<ABuffer> buffer = mPrefetcher->take(1, uri, 0, -1);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(readSegment(uri), toString(buffer));
+
+    // handed over only once
+    EXPECT_EQ(-1, mPrefetcher->getSeqNumber());
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, uri, 0, -1));
+}
+
+TEST_F(SegmentPrefetcherTest, TakeReturnsByteRange) {
+    const AString uri = addSegment("seg1.ts", kSegmentSize);
+    mPrefetcher->fetchAsync(1, uri, 1000, 50000);
+
+    sp<ABuffer> buffer = mPrefetcher->take(1, uri, 1000, 50000);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(readSegment(uri, 1000, 50000), toString(buffer));
+}
+
+// Asking for another segment leaves the one held in place.
+TEST_F(SegmentPrefetcherTest, TakeOnlyMatchingSegment) {
+    const AString uri = addSegment("seg1.ts", kSegmentSize);
+    const AString otherUri = addSegment("seg2.ts", kSegmentSize);
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+
+    EXPECT_EQ(nullptr, mPrefetcher->take(2, uri, 0, -1));
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, otherUri, 0, -1));
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, uri, 1000, -1));
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, uri, 0, 1000));
+    EXPECT_EQ(1, mPrefetcher->getSeqNumber());
+
+    sp<ABuffer> buffer = mPrefetcher->take(1, uri, 0, -1);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(readSegment(uri), toString(buffer));
+}
+
+TEST_F(SegmentPrefetcherTest, TakeWaitsForDownload) {
+    const AString uri = addSegment("seg1.ts", kSegmentSize);
+    mService->holdReads();
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+    std::thread releaser([this] {
+        mService->waitForHeldRead();
+        mService->releaseReads();
+    });
+
+    sp<ABuffer> buffer = mPrefetcher->take(1, uri, 0, -1);
+    releaser.join();
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(readSegment(uri), toString(buffer));
+}
+
+TEST_F(SegmentPrefetcherTest, CancelDropsDownload) {
+    const AString uri = addSegment("seg1.ts", kSegmentSize);
+    mService->holdReads();
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+    mService->waitForHeldRead();
+
+    mPrefetcher->cancel();
+    EXPECT_EQ(-1, mPrefetcher->getSeqNumber());
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, uri, 0, -1));
+
+    // the aborted connection is usable again
+    mService->releaseReads();
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+    sp<ABuffer> buffer = mPrefetcher->take(1, uri, 0, -1);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(readSegment(uri), toString(buffer));
+}
+
+TEST_F(SegmentPrefetcherTest, CancelWakesWaitingTake) {
+    const AString uri = addSegment("seg1.ts", kSegmentSize);
+    mService->holdReads();
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+    std::thread canceller([this] {
+        mService->waitForHeldRead();
+        mPrefetcher->cancel();
+    });
+
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, uri, 0, -1));
+    canceller.join();
+}
+
+// A download superseded by a newer one must not land in place of it.
+TEST_F(SegmentPrefetcherTest, NewFetchSupersedesDownload) {
+    const AString uri = addSegment("seg1.ts", kSegmentSize);
+    const AString nextUri = addSegment("seg2.ts", kSegmentSize);
+    mService->holdReads();
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+    mService->waitForHeldRead();
+
+    mPrefetcher->fetchAsync(2, nextUri, 0, -1);
+    EXPECT_EQ(2, mPrefetcher->getSeqNumber());
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, uri, 0, -1));
+
+    mService->releaseReads();
+    sp<ABuffer> buffer = mPrefetcher->take(2, nextUri, 0, -1);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(readSegment(nextUri), toString(buffer));
+}
+
+TEST_F(SegmentPrefetcherTest, OversizedSegmentNotPrefetched) {
+    const AString uri = addSegment("seg1.ts", kMaxBytes + 1);
+    mPrefetcher->fetchAsync(1, uri, 0, -1);
+    EXPECT_EQ(nullptr, mPrefetcher->take(1, uri, 0, -1));
+}
+
+class BandwidthEstimatorTest : public ::testing::Test {
+protected:
+    using BandwidthEstimator = LiveSession::BandwidthEstimator;
+
+    // Adds transfers of 125000 bytes, ie. 1 Mbit/s for 1 second, that lasted
+    // delayUs each and ended at the given times, and returns the estimate.
+    static int32_t estimate(int64_t delayUs, std::initializer_list<int64_t> endTimesUs) {
+        sp<BandwidthEstimator> estimator = new BandwidthEstimator();
+        for (int64_t endTimeUs : endTimesUs) {
+            estimator->addBandwidthMeasurement(125000, delayUs, endTimeUs);
+        }
+        int32_t bandwidthBps = -1;
+        EXPECT_TRUE(estimator->estimateBandwidth(&bandwidthBps));
+        return bandwidthBps;
+    }
+};
+
+TEST_F(BandwidthEstimatorTest, NeedsTwoTransfers) {
+    sp<BandwidthEstimator> estimator = new BandwidthEstimator();
+    estimator->addBandwidthMeasurement(125000, 1000000, 10000000);
+    int32_t bandwidthBps;
+    EXPECT_FALSE(estimator->estimateBandwidth(&bandwidthBps));
+}
+
+TEST_F(BandwidthEstimatorTest, DisjointTransfersKeepTheirTime) {
+    EXPECT_EQ(1000000, estimate(1000000, {10000000, 12000000}));
+    EXPECT_EQ(1000000, estimate(1000000, {10000000, 11000000}));
+}
+
+// Concurrent transfers add up to the throughput of the link.
+TEST_F(BandwidthEstimatorTest, OverlappingTransfersCountTimeOnce) {
+    // fully overlapping: 2 Mbit in 1 second
+    EXPECT_EQ(2000000, estimate(1000000, {10000000, 10000000}));
+    // half overlapping: 2 Mbit in 1.5 seconds
+    EXPECT_EQ(1333333, estimate(1000000, {10000000, 10500000}));
+    // three connections, staggered by 0.25 second: 3 Mbit in 1.5 seconds
+    EXPECT_EQ(2000000, estimate(1000000, {10000000, 10250000, 10500000}));
+}
+
+}  // namespace android
@@ -17,6 +17,7 @@
 #ifndef FRAME_DECODER_H_
 #define FRAME_DECODER_H_
 
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -64,6 +65,11 @@ protected:
 
     virtual status_t onExtractRect(FrameRect *rect) = 0;
 
+    // Number of decoder instances the samples may be spread over, called after
+    // onGetFormatAndSeekOptions(). Only samples that decode independently of each
+    // other, into exactly one output each, may use more than one.
+    virtual size_t onGetDecoderCount() { return 1; }
+
     virtual status_t onInputReceived(
             const sp<MediaCodecBuffer> &codecBuffer,
             MetaDataBase &sampleMeta,
@@ -91,12 +97,24 @@ private:
     int32_t mDstBpp;
     sp<IMemory> mFrameMemory;
     MediaSource::ReadOptions mReadOptions;
-    sp<MediaCodec> mDecoder;
-    sp<AMessage> mOutputFormat;
+    std::vector<sp<MediaCodec>> mDecoders;
+    std::vector<sp<AMessage>> mOutputFormats;
+    // Index of the decoder of each queued input not yet output, oldest first,
+    // only tracked when there are several decoders.
+    std::deque<size_t> mPendingOutputs;
+    // Decoders still to be sent an EOS once the source has run out.
+    std::vector<bool> mEosPending;
+    size_t mNextInputDecoder;
     bool mHaveMoreInputs;
     bool mFirstSample;
     sp<Surface> mSurface;
 
+    status_t createDecoder(
+            const sp<AMessage> &videoFormat, const sp<Surface> &surface,
+            sp<MediaCodec> *decoder);
+    status_t dequeueInputBuffer(size_t *decoderIndex, size_t *index);
+    void signalEosToOtherDecoders(size_t decoderIndex);
+    void queuePendingEos();
     status_t extractInternal();
 
     DISALLOW_EVIL_CONSTRUCTORS(FrameDecoder);
@@ -162,6 +180,8 @@ protected:
 
     virtual status_t onExtractRect(FrameRect *rect) override;
 
+    virtual size_t onGetDecoderCount() override;
+
     virtual status_t onInputReceived(
             const sp<MediaCodecBuffer> &codecBuffer __unused,
             MetaDataBase &sampleMeta __unused,
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "FrameDecoder_test"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <FrameDecoder.h>
+#include <binder/IMemory.h>
+#include <binder/ProcessState.h>
+#include <media/IMediaSource.h>
+#include <media/MediaCodecBuffer.h>
+#include <media/stagefright/MediaBuffer.h>
+#include <media/stagefright/MediaCodec.h>
+#include <media/stagefright/MediaCodecConstants.h>
+#include <media/stagefright/MediaDefs.h>
+#include <media/stagefright/MetaData.h>
+#include <media/stagefright/foundation/ALooper.h>
+#include <media/stagefright/foundation/AMessage.h>
+#include <system/graphics.h>
+
+namespace android {
+
+static const char *kDecoderName = "c2.android.avc.decoder";
+static const int32_t kTileWidth = 128;
+static const int32_t kTileHeight = 96;
+static const int32_t kGridCols = 3;
+static const int32_t kGridRows = 3;
+// The picture crops the last column and row of tiles.
+static const int32_t kWidth = kTileWidth * kGridCols - 40;
+static const int32_t kHeight = kTileHeight * kGridRows - 24;
+static const int64_t kEncodeTimeoutUs = 10000000LL;
+
+// Serves the tiles of a grid image in order, as the HEIF extractor does.
+struct TileSource : public IMediaSource {
+    explicit TileSource(const std::vector<std::vector<uint8_t>> &tiles)
+        : mTiles(tiles), mNext(0) {}
+
+    status_t start(MetaData *) override { mNext = 0; return OK; }
+    status_t stop() override { return OK; }
+    sp<MetaData> getFormat() override { return nullptr; }
+    status_t read(MediaBufferBase **buffer, const MediaSource::ReadOptions *) override {
+        *buffer = nullptr;
+        if (mNext >= mTiles.size()) {
+            return ERROR_END_OF_STREAM;
+        }
+        const std::vector<uint8_t> &tile = mTiles[mNext];
+        MediaBuffer *mbuf = new MediaBuffer(tile.size());
+        memcpy(mbuf->data(), tile.data(), tile.size());
+        mbuf->meta_data().setInt64(kKeyTime, mNext * 33333LL);
+        ++mNext;
+        *buffer = mbuf;
+        return OK;
+    }
+    status_t readMultiple(Vector<MediaBufferBase *> *, uint32_t,
+            const MediaSource::ReadOptions *) override { return ERROR_UNSUPPORTED; }
+    bool supportReadMultiple() override { return false; }
+    bool supportNonblockingRead() override { return false; }
+    status_t pause() override { return ERROR_UNSUPPORTED; }
+
+protected:
+    IBinder *onAsBinder() override { return nullptr; }
+
+private:
+    const std::vector<std::vector<uint8_t>> &mTiles;
+    size_t mNext;
+};
+
+// Decodes the grid on a given number of decoder instances.
+struct TestImageDecoder : public MediaImageDecoder {
+    TestImageDecoder(const sp<MetaData> &trackMeta, const sp<IMediaSource> &source,
+            size_t numDecoders)
+        : MediaImageDecoder(AString(kDecoderName), trackMeta, source),
+          mNumDecoders(numDecoders) {}
+
+protected:
+    size_t onGetDecoderCount() override { return mNumDecoders; }
+
+private:
+    const size_t mNumDecoders;
+};
+
+class FrameDecoderTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        ProcessState::self()->startThreadPool();
+        sTiles = encodeTiles();
+    }
+
+    // Encodes each tile as an independent AVC frame, with the parameter sets
+    // in-band so that any decoder instance can decode any tile.
+    static std::vector<std::vector<uint8_t>> encodeTiles() {
+        std::vector<std::vector<uint8_t>> tiles;
+        sp<ALooper> looper = new ALooper;
+        looper->start();
+        sp<MediaCodec> encoder = MediaCodec::CreateByType(looper, MIMETYPE_VIDEO_AVC, true);
+        if (encoder == nullptr) {
+            return tiles;
+        }
+        sp<AMessage> format = new AMessage;
+        format->setString("mime", MIMETYPE_VIDEO_AVC);
+        format->setInt32("width", kTileWidth);
+        format->setInt32("height", kTileHeight);
+        format->setInt32("color-format", COLOR_FormatYUV420Flexible);
+        format->setInt32("bitrate", 2000000);
+        format->setInt32("frame-rate", 30);
+        format->setInt32("i-frame-interval", 0);
+        if (encoder->configure(format, nullptr, nullptr, MediaCodec::CONFIGURE_FLAG_ENCODE) != OK
+                || encoder->start() != OK) {
+            encoder->release();
+            return tiles;
+        }
+
+        const size_t numTiles = kGridCols * kGridRows;
+        const size_t frameSize = kTileWidth * kTileHeight * 3 / 2;
+        std::vector<uint8_t> parameterSets;
+        size_t queued = 0;
+        bool done = false;
+        for (int64_t waitedUs = 0; !done && waitedUs < kEncodeTimeoutUs; waitedUs += 10000) {
+            size_t index;
+            if (queued <= numTiles && encoder->dequeueInputBuffer(&index, 0) == OK) {
+                sp<MediaCodecBuffer> buffer;
+                encoder->getInputBuffer(index, &buffer);
+                size_t size = 0;
+                uint32_t flags = MediaCodec::BUFFER_FLAG_EOS;
+                if (queued < numTiles) {
+                    // A different gradient in each tile.
+                    size = std::min(frameSize, buffer->capacity());
+                    for (size_t i = 0; i < size; ++i) {
+                        const size_t x = i % kTileWidth, y = i / kTileWidth;
+                        buffer->base()[i] = (uint8_t)(x * (queued + 1) + y * 3 + queued * 29);
+                    }
+                    flags = 0;
+                }
+                encoder->queueInputBuffer(index, 0, size, queued * 33333LL, flags);
+                ++queued;
+            }
+            size_t offset, size;
+            int64_t timeUs;
+            uint32_t flags;
+            if (encoder->dequeueOutputBuffer(
+                    &index, &offset, &size, &timeUs, &flags, 10000) != OK) {
+                continue;
+            }
+            sp<MediaCodecBuffer> buffer;
+            encoder->getOutputBuffer(index, &buffer);
+            const uint8_t *data = buffer->base() + offset;
+            if (flags & MediaCodec::BUFFER_FLAG_CODECCONFIG) {
+                parameterSets.assign(data, data + size);
+            } else if (size > 0) {
+                std::vector<uint8_t> tile(parameterSets);
+                tile.insert(tile.end(), data, data + size);
+                tiles.push_back(std::move(tile));
+            }
+            done = (flags & MediaCodec::BUFFER_FLAG_EOS) != 0;
+            encoder->releaseOutputBuffer(index);
+        }
+        encoder->release();
+        looper->stop();
+        return tiles;
+    }
+
+    static sp<MetaData> gridMeta() {
+        sp<MetaData> meta = new MetaData;
+        meta->setCString(kKeyMIMEType, MEDIA_MIMETYPE_VIDEO_AVC);
+        meta->setInt32(kKeyWidth, kWidth);
+        meta->setInt32(kKeyHeight, kHeight);
+        meta->setInt32(kKeyTileWidth, kTileWidth);
+        meta->setInt32(kKeyTileHeight, kTileHeight);
+        meta->setInt32(kKeyGridCols, kGridCols);
+        meta->setInt32(kKeyGridRows, kGridRows);
+        return meta;
+    }
+
+    // Returns the decoded picture, or the picture of each row of tiles in turn.
+    static std::vector<std::vector<uint8_t>> decode(size_t numDecoders, bool byRow) {
+        std::vector<std::vector<uint8_t>> frames;
+        sp<FrameDecoder> decoder =
+                new TestImageDecoder(gridMeta(), new TileSource(sTiles), numDecoders);
+        if (decoder->init(0 /* frameTimeUs */, MediaSource::ReadOptions::SEEK_PREVIOUS_SYNC,
+                HAL_PIXEL_FORMAT_RGBA_8888) != OK) {
+            return frames;
+        }
+        for (int32_t row = 0; row < (byRow ? kGridRows : 1); ++row) {
+            FrameRect rect = {0, row * kTileHeight, kWidth,
+                    std::min(kHeight, (row + 1) * kTileHeight)};
+            sp<IMemory> frame = decoder->extractFrame(byRow ? &rect : nullptr);
+            if (frame == nullptr) {
+                break;
+            }
+            const uint8_t *data = (const uint8_t *)frame->unsecurePointer();
+            frames.emplace_back(data, data + frame->size());
+        }
+        return frames;
+    }
+
+    static std::vector<std::vector<uint8_t>> sTiles;
+};
+
+std::vector<std::vector<uint8_t>> FrameDecoderTest::sTiles;
+
+// Tiles spread over several decoders must compose the same picture as one decoder.
+TEST_F(FrameDecoderTest, MultipleTileDecodersMatchOne) {
+    ASSERT_EQ((size_t)(kGridCols * kGridRows), sTiles.size());
+    const std::vector<std::vector<uint8_t>> expected = decode(1, false /* byRow */);
+    ASSERT_EQ(1u, expected.size());
+
+    for (size_t numDecoders = 2; numDecoders <= 4; ++numDecoders) {
+        EXPECT_EQ(expected, decode(numDecoders, false /* byRow */))
+                << numDecoders << " decoders";
+    }
+}
+
+// Row by row extraction relies on tiles being output in source order.
+TEST_F(FrameDecoderTest, MultipleTileDecodersMatchOneByRow) {
+    ASSERT_EQ((size_t)(kGridCols * kGridRows), sTiles.size());
+    const std::vector<std::vector<uint8_t>> expected = decode(1, true /* byRow */);
+    ASSERT_EQ((size_t)kGridRows, expected.size());
+
+    for (size_t numDecoders = 2; numDecoders <= 4; ++numDecoders) {
+        EXPECT_EQ(expected, decode(numDecoders, true /* byRow */))
+                << numDecoders << " decoders";
+    }
+}
+
+}  // namespace android
@@ -584,7 +584,30 @@ int64_t BlockIterator::blockTimeUs() const {
 }
 
 void BlockIterator::seekwithoutcue_l(int64_t seekTimeUs, int64_t *actualFrameTimeUs) {
-    mCluster = mExtractor->mSegment->FindCluster(seekTimeUs * 1000ll);
+    mkvparser::Segment *const pSegment = mExtractor->mSegment;
+
+    // FindCluster() binary searches the loaded clusters, and files without Cues
+    // only load the first one when opened. Load clusters up to the seek time first:
+    // for clusters of known size this reads only their headers, where walking
+    // blocks with advance_l() would parse every block in between. Loaded clusters
+    // stay in the segment, so later seeks search them directly.
+    const mkvparser::Cluster *pLast = pSegment->GetLast();
+    while (pLast != NULL && !pLast->EOS() && pLast->GetTime() >= 0
+            && pLast->GetTime() <= seekTimeUs * 1000ll) {
+        long long pos;
+        long len;
+        if (pSegment->LoadCluster(pos, len) != 0) {
+            // end of stream or error: search what we have
+            break;
+        }
+        const mkvparser::Cluster *pNext = pSegment->GetLast();
+        if (pNext == pLast) {
+            break;
+        }
+        pLast = pNext;
+    }
+
+    mCluster = pSegment->FindCluster(seekTimeUs * 1000ll);
     const long status = mCluster->GetFirst(mBlockEntry);
     if (status < 0) {  // error
         ALOGE("get last blockenry failed!");
@@ -1401,14 +1424,10 @@ MatroskaExtractor::MatroskaExtractor(DataSourceHelper *source)
                 }
             }
 
-            if (mCues) {
-                long len;
-                ret = mSegment->LoadCluster(pos, len);
-                ALOGV("has Cue data, Cluster num=%ld", mSegment->GetCount());
-            } else  {
-                long status_Load = mSegment->Load();
-                ALOGW("no Cue data,Segment Load status:%ld",status_Load);
-            }
+            // Without Cues, seeks load the clusters they need, see seekwithoutcue_l().
+            long len;
+            ret = mSegment->LoadCluster(pos, len);
+            ALOGV("%s Cue data, Cluster num=%ld", mCues ? "has" : "no", mSegment->GetCount());
         } else if (ret > 0) {
             ret = mkvparser::E_BUFFER_NOT_FULL;
         }
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <MatroskaExtractor.h>
+#include <gtest/gtest.h>
+#include <media/MediaExtractorPluginHelper.h>
+#include <media/NdkMediaFormat.h>
+#include <media/stagefright/MediaBufferGroup.h>
+
+namespace {
+
+using namespace android;
+
+constexpr int64_t kFrameDurationMs = 40;
+constexpr size_t kFramesPerKeyFrame = 25;
+constexpr size_t kFramesPerCluster = 50;
+
+class BufferSource : public DataSourceHelper {
+public:
+    explicit BufferSource(const std::vector<uint8_t> &data)
+        : DataSourceHelper((CDataSource *)nullptr), mData(data), mMaxReadEnd(0) {}
+
+    ssize_t readAt(off64_t offset, void *data, size_t size) override {
+        if (offset < 0 || offset >= (off64_t)mData.size()) {
+            return 0;
+        }
+        size = std::min(size, (size_t)(mData.size() - offset));
+        memcpy(data, mData.data() + offset, size);
+        mMaxReadEnd = std::max(mMaxReadEnd, (off64_t)(offset + size));
+        return size;
+    }
+
+    status_t getSize(off64_t *size) override {
+        *size = mData.size();
+        return OK;
+    }
+
+    uint32_t flags() override { return 0; }
+
+    // How far into the file anything was read.
+    off64_t maxReadEnd() const { return mMaxReadEnd; }
+
+private:
+    const std::vector<uint8_t> &mData;
+    off64_t mMaxReadEnd;
+};
+
+// A VP8 WebM file with neither Cues nor a SeekHead, as written by recorders that
+// never finalize the file. Clusters have known sizes, frames come every 40 ms and
+// every 25th is a key frame.
+class WebmStream {
+public:
+    std::vector<uint8_t> mData;
+    std::vector<int64_t> mKeyFrameTimesUs;
+
+    WebmStream(size_t numFrames, uint32_t seed) {
+        std::mt19937 rng(seed);
+
+        std::vector<uint8_t> ebml;
+        addUInt(&ebml, 0x4286, 1);           // EBMLVersion
+        addUInt(&ebml, 0x42F7, 1);           // EBMLReadVersion
+        addUInt(&ebml, 0x42F2, 4);           // EBMLMaxIDLength
+        addUInt(&ebml, 0x42F3, 8);           // EBMLMaxSizeLength
+        addString(&ebml, 0x4282, "webm");    // DocType
+        addUInt(&ebml, 0x4287, 2);           // DocTypeVersion
+        addUInt(&ebml, 0x4285, 2);           // DocTypeReadVersion
+        addElement(&mData, 0x1A45DFA3, ebml);
+
+        std::vector<uint8_t> segment;
+
+        std::vector<uint8_t> info;
+        addUInt(&info, 0x2AD7B1, 1000000);   // TimecodeScale: milliseconds
+        addFloat(&info, 0x4489, numFrames * kFrameDurationMs);  // Duration
+        addString(&info, 0x4D80, "test");    // MuxingApp
+        addString(&info, 0x5741, "test");    // WritingApp
+        addElement(&segment, 0x1549A966, info);
+
+        std::vector<uint8_t> video;
+        addUInt(&video, 0xB0, 64);           // PixelWidth
+        addUInt(&video, 0xBA, 64);           // PixelHeight
+        std::vector<uint8_t> trackEntry;
+        addUInt(&trackEntry, 0xD7, 1);       // TrackNumber
+        addUInt(&trackEntry, 0x73C5, 1);     // TrackUID
+        addUInt(&trackEntry, 0x83, 1);       // TrackType: video
+        addString(&trackEntry, 0x86, "V_VP8");  // CodecID
+        addElement(&trackEntry, 0xE0, video);
+        std::vector<uint8_t> tracks;
+        addElement(&tracks, 0xAE, trackEntry);
+        addElement(&segment, 0x1654AE6B, tracks);
+
+        for (size_t first = 0; first < numFrames; first += kFramesPerCluster) {
+            const int64_t clusterTimeMs = first * kFrameDurationMs;
+            std::vector<uint8_t> cluster;
+            addUInt(&cluster, 0xE7, clusterTimeMs);  // Timecode
+            for (size_t i = first; i < std::min(first + kFramesPerCluster, numFrames); ++i) {
+                const bool isKey = i % kFramesPerKeyFrame == 0;
+                if (isKey) {
+                    mKeyFrameTimesUs.push_back(i * kFrameDurationMs * 1000);
+                }
+                const int16_t relativeTimeMs = i * kFrameDurationMs - clusterTimeMs;
+                std::vector<uint8_t> block = {
+                    0x81,                            // track number 1
+                    (uint8_t)(relativeTimeMs >> 8),
+                    (uint8_t)relativeTimeMs,
+                    (uint8_t)(isKey ? 0x80 : 0x00),  // flags
+                };
+                block.resize(block.size() + 200 + rng() % 1000, (uint8_t)i);
+                addElement(&cluster, 0xA3, block);  // SimpleBlock
+            }
+            addElement(&segment, 0x1F43B675, cluster);
+        }
+
+        addElement(&mData, 0x18538067, segment);
+    }
+
+    // A video seek lands on the first key frame at or after the target.
+    int64_t keyFrameForSeek(int64_t timeUs) const {
+        return *std::lower_bound(mKeyFrameTimesUs.begin(), mKeyFrameTimesUs.end(), timeUs);
+    }
+
+private:
+    static void addId(std::vector<uint8_t> *out, uint32_t id) {
+        int shift = 24;
+        while (shift > 0 && (id >> shift) == 0) {
+            shift -= 8;
+        }
+        for (; shift >= 0; shift -= 8) {
+            out->push_back(id >> shift);
+        }
+    }
+
+    // Sizes are always written on 8 bytes, which every parser accepts.
+    static void addSize(std::vector<uint8_t> *out, uint64_t size) {
+        out->push_back(0x01);
+        for (int shift = 48; shift >= 0; shift -= 8) {
+            out->push_back(size >> shift);
+        }
+    }
+
+    static void addElement(
+            std::vector<uint8_t> *out, uint32_t id, const std::vector<uint8_t> &payload) {
+        addId(out, id);
+        addSize(out, payload.size());
+        out->insert(out->end(), payload.begin(), payload.end());
+    }
+
+    static void addUInt(std::vector<uint8_t> *out, uint32_t id, uint64_t value) {
+        std::vector<uint8_t> payload;
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            payload.push_back(value >> shift);
+        }
+        addElement(out, id, payload);
+    }
+
+    static void addFloat(std::vector<uint8_t> *out, uint32_t id, double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        addUInt(out, id, bits);
+    }
+
+    static void addString(std::vector<uint8_t> *out, uint32_t id, const std::string &value) {
+        addElement(out, id, std::vector<uint8_t>(value.begin(), value.end()));
+    }
+};
+
+class MatroskaSeekWithoutCuesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        mSource = new BufferSource(mStream.mData);
+        mExtractor = new MatroskaExtractor(mSource);
+        ASSERT_EQ(1u, mExtractor->countTracks());
+        mTrack = mExtractor->getTrack(0);
+        ASSERT_NE(nullptr, mTrack);
+        mCTrack = wrap(mTrack);
+        ASSERT_EQ(AMEDIA_OK, mCTrack->start(mTrack, mBufferGroup.wrap()));
+    }
+
+    void TearDown() override {
+        if (mCTrack != nullptr) {
+            mCTrack->stop(mTrack);
+            mCTrack->free(mTrack);
+            free(mCTrack);
+        }
+        delete mExtractor;
+    }
+
+    // Seeks to seekTimeUs and returns the time of the frame read there.
+    int64_t seekAndRead(int64_t seekTimeUs) {
+        MediaTrackHelper::ReadOptions options(
+                CMediaTrackReadOptions::SEEK | CMediaTrackReadOptions::SEEK_CLOSEST_SYNC,
+                seekTimeUs);
+        MediaBufferHelper *buffer = nullptr;
+        EXPECT_EQ(AMEDIA_OK, mTrack->read(&buffer, &options));
+        if (buffer == nullptr) {
+            return -1;
+        }
+        int64_t timeUs = -1;
+        EXPECT_TRUE(AMediaFormat_getInt64(buffer->meta_data(), AMEDIAFORMAT_KEY_TIME_US, &timeUs));
+        buffer->release();
+        return timeUs;
+    }
+
+    // About 5 MB, 10 minutes.
+    WebmStream mStream{15000, 1};
+    BufferSource *mSource = nullptr;
+    MediaExtractorPluginHelper *mExtractor = nullptr;
+    MediaTrackHelper *mTrack = nullptr;
+    CMediaTrack *mCTrack = nullptr;
+    MediaBufferGroup mBufferGroup;
+};
+
+// Opening a file without Cues must not walk its clusters, and a seek reads only
+// up to the cluster it lands in.
+TEST_F(MatroskaSeekWithoutCuesTest, SeekReadsOnlyClustersUpToTarget) {
+    const off64_t size = mStream.mData.size();
+    EXPECT_LT(mSource->maxReadEnd(), size / 20);
+
+    const int64_t seekTimeUs = mStream.mKeyFrameTimesUs[mStream.mKeyFrameTimesUs.size() / 2];
+    EXPECT_EQ(seekTimeUs, seekAndRead(seekTimeUs));
+    EXPECT_LT(mSource->maxReadEnd(), size * 6 / 10);
+}
+
+// Seeks in any order land on the key frame a walk of every block finds.
+TEST_F(MatroskaSeekWithoutCuesTest, SeekMatchesBlockWalk) {
+    std::vector<int64_t> seekTimesUs;
+    for (int64_t timeUs = 1; timeUs <= mStream.mKeyFrameTimesUs.back(); timeUs += 777777) {
+        seekTimesUs.push_back(timeUs);
+    }
+    std::shuffle(seekTimesUs.begin(), seekTimesUs.end(), std::mt19937(2));
+
+    for (int64_t seekTimeUs : seekTimesUs) {
+        EXPECT_EQ(mStream.keyFrameForSeek(seekTimeUs), seekAndRead(seekTimeUs))
+                << "seek to " << seekTimeUs;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "FrameIndexSeeker"
+
+#include <inttypes.h>
+
+#include <utils/Log.h>
+
+#include "FrameIndexSeeker.h"
+
+#include <media/stagefright/foundation/avc_utils.h>
+
+#include <media/stagefright/foundation/ByteUtils.h>
+
+#include <media/MediaExtractorPluginApi.h>
+#include <media/MediaExtractorPluginHelper.h>
+
+namespace android {
+
+// Same as MP3Extractor: the bits that must not change from frame to frame.
+static const uint32_t kMask = 0xfffe0c00;
+
+// Limits on how much a single seek reads: the forward walk, and the search for the
+// next frame after sync is lost.
+static const off64_t kMaxScanBytesPerSeek = 4 * 1024 * 1024;
+static const off64_t kMaxResyncBytes = 128 * 1024;
+
+// When the index fills up, every other entry is dropped and the spacing doubles.
+static const size_t kMaxEntries = 4096;
+
+FrameIndexSeeker::FrameIndexSeeker(
+        DataSourceHelper *source, off64_t first_frame_pos, uint32_t fixed_header)
+    : mSource(source),
+      mFirstFramePos(first_frame_pos),
+      mFixedHeader(fixed_header),
+      mSampleRate(0),
+      mSamplesPerEntry(0),
+      mScanPos(first_frame_pos),
+      mScanSamples(0),
+      mScanDone(false),
+      mBufferPos(0),
+      mBufferLength(0) {
+    size_t frameSize;
+    GetMPEGAudioFrameSize(fixed_header, &frameSize, &mSampleRate);
+    mSamplesPerEntry = mSampleRate;
+}
+
+bool FrameIndexSeeker::getDuration(int64_t *durationUs) {
+    // Only known once every frame has been walked.
+    if (!mScanDone || mSampleRate <= 0) {
+        return false;
+    }
+
+    *durationUs = mScanSamples * 1000000ll / mSampleRate;
+
+    return true;
+}
+
+bool FrameIndexSeeker::getOffsetForTime(int64_t *timeUs, off64_t *pos) {
+    if (mSampleRate <= 0) {
+        return false;
+    }
+
+    int64_t targetSamples;
+    if (__builtin_mul_overflow(*timeUs < 0 ? 0 : *timeUs, (int64_t)mSampleRate,
+            &targetSamples)) {
+        return false;
+    }
+    targetSamples /= 1000000;
+
+    if (!mScanDone && targetSamples >= mScanSamples) {
+        scan(targetSamples, kMaxScanBytesPerSeek);
+    }
+
+    if (!mScanDone && targetSamples >= mScanSamples) {
+        // Still short of the target: extrapolate at the average bitrate measured so far.
+        if (mScanSamples == 0) {
+            return false;
+        }
+        double bytesPerSample = (double)(mScanPos - mFirstFramePos) / mScanSamples;
+        off64_t framePos = mScanPos + (off64_t)((targetSamples - mScanSamples) * bytesPerSample);
+
+        // The estimate rarely falls on a frame. Move to the next one here, rather than
+        // leave it to MP3Source, so the time reported is that frame's and not the
+        // requested one. resync() starts one byte in, so back up one first.
+        --framePos;
+        if (!resync(&framePos)) {
+            return false;
+        }
+
+        *pos = framePos;
+        *timeUs = (mScanSamples + (int64_t)((framePos - mScanPos) / bytesPerSample))
+                * 1000000ll / mSampleRate;
+
+        ALOGV("getOffsetForTime %lld us => 0x%016llx (extrapolated)",
+                (long long)*timeUs, (long long)*pos);
+
+        return true;
+    }
+
+    // Start from the last indexed frame at or before the target.
+    size_t left = 0;
+    size_t right = mEntries.size();
+    while (left < right) {
+        size_t center = left + (right - left) / 2;
+        if (mEntries.itemAt(center).mSamples <= targetSamples) {
+            left = center + 1;
+        } else {
+            right = center;
+        }
+    }
+    off64_t framePos = mFirstFramePos;
+    int64_t samples = 0;
+    if (left > 0) {
+        framePos = mEntries.itemAt(left - 1).mPos;
+        samples = mEntries.itemAt(left - 1).mSamples;
+    }
+
+    // Then walk to the frame holding the target sample.
+    size_t frameSize;
+    int numSamples;
+    while (framePos < mScanPos) {
+        if (!readFrame(framePos, &frameSize, &numSamples)) {
+            // The scan already got past this, so resync() will too.
+            if (!resync(&framePos)) {
+                break;
+            }
+            continue;
+        }
+        if (samples + numSamples > targetSamples) {
+            break;
+        }
+        framePos += frameSize;
+        samples += numSamples;
+    }
+
+    *pos = framePos;
+    *timeUs = samples * 1000000ll / mSampleRate;
+
+    ALOGV("getOffsetForTime %lld us => 0x%016llx", (long long)*timeUs, (long long)*pos);
+
+    return true;
+}
+
+bool FrameIndexSeeker::readFrame(off64_t pos, size_t *frameSize, int *numSamples) {
+    if (pos < mBufferPos || pos + 4 > mBufferPos + (off64_t)mBufferLength) {
+        ssize_t n = mSource->readAt(pos, mBuffer, sizeof(mBuffer));
+        if (n < 4) {
+            mBufferLength = 0;
+            return false;
+        }
+        mBufferPos = pos;
+        mBufferLength = n;
+    }
+
+    uint32_t header = U32_AT(&mBuffer[pos - mBufferPos]);
+
+    return (header & kMask) == (mFixedHeader & kMask)
+            && GetMPEGAudioFrameSize(header, frameSize, NULL, NULL, NULL, numSamples);
+}
+
+// Find the next position after *pos where two consecutive valid frames start.
+bool FrameIndexSeeker::resync(off64_t *pos) {
+    size_t frameSize;
+    int numSamples;
+    for (off64_t candidate = *pos + 1; candidate < *pos + kMaxResyncBytes; ++candidate) {
+        if (readFrame(candidate, &frameSize, &numSamples)
+                && readFrame(candidate + frameSize, &frameSize, &numSamples)) {
+            *pos = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameIndexSeeker::scan(int64_t targetSamples, off64_t maxBytes) {
+    const off64_t endPos = mScanPos + maxBytes;
+    size_t frameSize;
+    int numSamples;
+    while (mScanSamples <= targetSamples && mScanPos < endPos) {
+        if (!readFrame(mScanPos, &frameSize, &numSamples)) {
+            off64_t pos = mScanPos;
+            if (!resync(&pos)) {
+                // End of stream, or trailing tags: nothing more to index.
+                ALOGV("scan done at 0x%016llx, %lld samples",
+                        (long long)mScanPos, (long long)mScanSamples);
+                mScanDone = true;
+                return;
+            }
+            ALOGV("lost sync at 0x%016llx, resumed at 0x%016llx",
+                    (long long)mScanPos, (long long)pos);
+            mScanPos = pos;
+            continue;
+        }
+
+        if (mEntries.isEmpty()
+                || mScanSamples - mEntries.top().mSamples >= mSamplesPerEntry) {
+            addEntry(mScanPos, mScanSamples);
+        }
+        mScanPos += frameSize;
+        mScanSamples += numSamples;
+    }
+}
+
+void FrameIndexSeeker::addEntry(off64_t pos, int64_t samples) {
+    if (mEntries.size() >= kMaxEntries) {
+        Vector<Entry> thinned;
+        thinned.setCapacity(kMaxEntries);
+        for (size_t i = 0; i < mEntries.size(); i += 2) {
+            thinned.push(mEntries.itemAt(i));
+        }
+        mEntries = thinned;
+        mSamplesPerEntry *= 2;
+    }
+
+    Entry entry;
+    entry.mPos = pos;
+    entry.mSamples = samples;
+    mEntries.push(entry);
+}
+
+}  // namespace android
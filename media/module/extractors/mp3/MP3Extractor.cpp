@@ -20,10 +20,12 @@
 
 #include "MP3Extractor.h"
 
+#include "FrameIndexSeeker.h"
 #include "ID3.h"
 #include "VBRISeeker.h"
 #include "XINGSeeker.h"
 
+#include <media/stagefright/DataSourceBase.h>
 #include <media/stagefright/foundation/ADebug.h>
 #include <media/stagefright/foundation/AMessage.h>
 #include <media/stagefright/foundation/avc_utils.h>
@@ -319,6 +321,13 @@ MP3Extractor::MP3Extractor(
     GetMPEGAudioFrameSize(
             header, &frame_size, &sample_rate, &num_channels, &bitrate);
 
+    if (mSeeker == NULL && !(mDataSource->flags() & DataSourceBase::kIsCachingDataSource)) {
+        // Without a XING or VBRI table, index the frames as seeks reach them rather
+        // than assuming the first frame's bitrate holds for the whole stream.
+        // Not for streamed content, where walking frames means downloading them.
+        mSeeker = new FrameIndexSeeker(mDataSource, mFirstFramePos, mFixedHeader);
+    }
+
     unsigned layer = 4 - ((header >> 17) & 3);
 
     switch (layer) {
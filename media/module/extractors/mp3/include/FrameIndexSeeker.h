@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRAME_INDEX_SEEKER_H_
+
+#define FRAME_INDEX_SEEKER_H_
+
+#include "MP3Seeker.h"
+
+#include <utils/Vector.h>
+
+namespace android {
+
+class DataSourceHelper;
+
+// Seeker for streams that carry neither a XING nor a VBRI table of contents.
+// Frame headers are walked only as far as seeks need, and the offset of a frame
+// roughly every second is kept, so seeking into the part already walked costs at
+// most a second's worth of header reads. Beyond it, offsets are extrapolated from
+// the average bitrate measured so far.
+struct FrameIndexSeeker : public MP3Seeker {
+    FrameIndexSeeker(
+            DataSourceHelper *source, off64_t first_frame_pos, uint32_t fixed_header);
+
+    virtual bool getDuration(int64_t *durationUs);
+    virtual bool getOffsetForTime(int64_t *timeUs, off64_t *pos);
+
+private:
+    static const size_t kBufferSize = 16 * 1024;
+
+    struct Entry {
+        off64_t mPos;
+        int64_t mSamples;  // samples in all frames before this one
+    };
+
+    DataSourceHelper *mSource;
+    off64_t mFirstFramePos;
+    uint32_t mFixedHeader;
+    int mSampleRate;
+
+    Vector<Entry> mEntries;
+    int64_t mSamplesPerEntry;
+
+    // The next frame the scan will parse, and the samples before it.
+    off64_t mScanPos;
+    int64_t mScanSamples;
+    bool mScanDone;
+
+    uint8_t mBuffer[kBufferSize];
+    off64_t mBufferPos;
+    size_t mBufferLength;
+
+    bool readFrame(off64_t pos, size_t *frameSize, int *numSamples);
+    bool resync(off64_t *pos);
+    void scan(int64_t targetSamples, off64_t maxBytes);
+    void addEntry(off64_t pos, int64_t samples);
+
+    DISALLOW_EVIL_CONSTRUCTORS(FrameIndexSeeker);
+};
+
+}  // namespace android
+
+#endif  // FRAME_INDEX_SEEKER_H_
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <FrameIndexSeeker.h>
+#include <gtest/gtest.h>
+#include <media/MediaExtractorPluginHelper.h>
+#include <media/stagefright/foundation/avc_utils.h>
+
+namespace {
+
+using android::DataSourceHelper;
+using android::FrameIndexSeeker;
+using android::status_t;
+
+// MPEG-1 layer III, 44.1 kHz, mono, no CRC. The bitrate index and padding bit are
+// filled in per frame.
+constexpr uint32_t kBaseHeader = 0xfffb00c0;
+constexpr int kSampleRate = 44100;
+constexpr int kSamplesPerFrame = 1152;
+
+class BufferSource : public DataSourceHelper {
+public:
+    explicit BufferSource(const std::vector<uint8_t> &data)
+        : DataSourceHelper((android::CDataSource *)nullptr), mData(data) {}
+
+    ssize_t readAt(off64_t offset, void *data, size_t size) override {
+        if (offset < 0 || offset >= (off64_t)mData.size()) {
+            return 0;
+        }
+        size = std::min(size, (size_t)(mData.size() - offset));
+        memcpy(data, mData.data() + offset, size);
+        return size;
+    }
+
+    status_t getSize(off64_t *size) override {
+        *size = mData.size();
+        return android::OK;
+    }
+
+    uint32_t flags() override { return 0; }
+
+private:
+    const std::vector<uint8_t> &mData;
+};
+
+// A VBR stream with stretches of junk between frames. mFrameOffsets is what a full
+// walk of the frame headers finds: frame i starts there, after i * kSamplesPerFrame
+// samples.
+struct Mp3Stream {
+    std::vector<uint8_t> mData;
+    std::vector<off64_t> mFrameOffsets;
+
+    Mp3Stream(size_t numFrames, uint32_t seed) {
+        std::mt19937 rng(seed);
+        for (size_t i = 0; i < numFrames; ++i) {
+            if (i > 0 && i % 1000 == 0) {
+                // Lost sync, e.g. a cut in the stream.
+                mData.resize(mData.size() + 1500, 0);
+            }
+            uint32_t bitrateIndex = 1 + rng() % 14;
+            uint32_t padding = rng() % 2;
+            uint32_t header = kBaseHeader | (bitrateIndex << 12) | (padding << 9);
+            size_t frameSize;
+            android::GetMPEGAudioFrameSize(header, &frameSize);
+
+            mFrameOffsets.push_back(mData.size());
+            mData.resize(mData.size() + frameSize, 0);
+            uint8_t *p = &mData[mFrameOffsets.back()];
+            p[0] = header >> 24;
+            p[1] = header >> 16;
+            p[2] = header >> 8;
+            p[3] = header;
+        }
+    }
+
+    int64_t timeUsOfFrame(size_t index) const {
+        return (int64_t)index * kSamplesPerFrame * 1000000ll / kSampleRate;
+    }
+
+    // The frame holding the sample at timeUs, or the last one.
+    size_t frameForTime(int64_t timeUs) const {
+        int64_t sample = std::max(timeUs, (int64_t)0) * kSampleRate / 1000000;
+        return std::min((size_t)(sample / kSamplesPerFrame), mFrameOffsets.size() - 1);
+    }
+
+    int64_t durationUs() const { return timeUsOfFrame(mFrameOffsets.size()); }
+};
+
+std::unique_ptr<FrameIndexSeeker> createSeeker(BufferSource *source, const Mp3Stream &stream) {
+    return std::make_unique<FrameIndexSeeker>(
+            source, stream.mFrameOffsets[0], kBaseHeader | (9 << 12));
+}
+
+// Seeks anywhere within reach of the walk land on the frame a full walk finds,
+// whatever order they come in.
+TEST(FrameIndexSeekerTest, SeekMatchesFullScan) {
+    // About 3 MB, under the most a single seek walks.
+    Mp3Stream stream(7000, 1);
+    BufferSource source(stream.mData);
+    std::unique_ptr<FrameIndexSeeker> seeker = createSeeker(&source, stream);
+
+    std::vector<int64_t> seekTimesUs;
+    for (int64_t timeUs = 0; timeUs < stream.durationUs(); timeUs += 977777) {
+        seekTimesUs.push_back(timeUs);
+    }
+    std::shuffle(seekTimesUs.begin(), seekTimesUs.end(), std::mt19937(2));
+
+    for (int64_t seekTimeUs : seekTimesUs) {
+        int64_t timeUs = seekTimeUs;
+        off64_t pos;
+        ASSERT_TRUE(seeker->getOffsetForTime(&timeUs, &pos)) << "seek to " << seekTimeUs;
+
+        size_t frame = stream.frameForTime(seekTimeUs);
+        EXPECT_EQ(stream.mFrameOffsets[frame], pos) << "seek to " << seekTimeUs;
+        EXPECT_EQ(stream.timeUsOfFrame(frame), timeUs) << "seek to " << seekTimeUs;
+    }
+}
+
+// Seeking past the last frame walks all of them, which gives the duration.
+TEST(FrameIndexSeekerTest, DurationAfterFullScan) {
+    Mp3Stream stream(3000, 3);
+    BufferSource source(stream.mData);
+    std::unique_ptr<FrameIndexSeeker> seeker = createSeeker(&source, stream);
+
+    int64_t durationUs;
+    EXPECT_FALSE(seeker->getDuration(&durationUs));
+
+    int64_t timeUs = stream.durationUs() * 2;
+    off64_t pos;
+    ASSERT_TRUE(seeker->getOffsetForTime(&timeUs, &pos));
+    EXPECT_EQ((off64_t)stream.mData.size(), pos);
+    EXPECT_EQ(stream.durationUs(), timeUs);
+
+    ASSERT_TRUE(seeker->getDuration(&durationUs));
+    EXPECT_EQ(stream.durationUs(), durationUs);
+}
+
+// A seek past what a single seek walks is extrapolated, but must still land on a
+// frame and report that frame's time, not the requested one.
+TEST(FrameIndexSeekerTest, ExtrapolatedSeekLandsOnFrame) {
+    // About 12 MB.
+    Mp3Stream stream(28000, 4);
+    BufferSource source(stream.mData);
+    std::unique_ptr<FrameIndexSeeker> seeker = createSeeker(&source, stream);
+
+    const int64_t seekTimeUs = stream.durationUs() * 9 / 10;
+    int64_t timeUs = seekTimeUs;
+    off64_t pos;
+    ASSERT_TRUE(seeker->getOffsetForTime(&timeUs, &pos));
+
+    auto it = std::find(stream.mFrameOffsets.begin(), stream.mFrameOffsets.end(), pos);
+    ASSERT_NE(stream.mFrameOffsets.end(), it) << "not a frame: " << pos;
+    int64_t frameTimeUs = stream.timeUsOfFrame(it - stream.mFrameOffsets.begin());
+    // Only an estimate at the average bitrate, but close to where the frame really is.
+    EXPECT_NEAR(frameTimeUs, timeUs, stream.durationUs() / 50);
+    EXPECT_NEAR(seekTimeUs, timeUs, stream.durationUs() / 50);
+
+    // Each seek walks further, so repeating it eventually lands exactly.
+    for (int i = 0; i < 3; ++i) {
+        timeUs = seekTimeUs;
+        ASSERT_TRUE(seeker->getOffsetForTime(&timeUs, &pos));
+    }
+    size_t frame = stream.frameForTime(seekTimeUs);
+    EXPECT_EQ(stream.mFrameOffsets[frame], pos);
+    EXPECT_EQ(stream.timeUsOfFrame(frame), timeUs);
+}
+
+}  // namespace
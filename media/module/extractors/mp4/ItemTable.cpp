@@ -48,7 +48,8 @@ struct ImageItem {
     ImageItem(uint32_t _type, uint32_t _id, bool _hidden) :
             type(_type), itemId(_id), hidden(_hidden),
             rows(0), columns(0), width(0), height(0), rotation(0),
-            offset(0), size(0), seenClap(false), nextTileIndex(0) {}
+            offset(0), size(0), seenClap(false), nextTileIndex(0),
+            resolved(false), resolveErr(OK) {}
 
     bool isGrid() const {
         return type == FOURCC("grid");
@@ -86,6 +87,12 @@ struct ImageItem {
     Vector<uint32_t> exifRefs;
     Vector<uint32_t> xmpRefs;
     size_t nextTileIndex;
+
+    // Indices of the associated properties, which are only attached to the item (and for
+    // grids, the grid layout read) once the item is needed, see ItemTable::resolveImageItem().
+    Vector<uint16_t> propertyIndices;
+    bool resolved;
+    status_t resolveErr;
 };
 
 struct ExternalMetaItem {
@@ -684,7 +691,7 @@ struct AssociationEntry {
 };
 
 struct ItemProperty : public RefBase {
-    ItemProperty() {}
+    ItemProperty() : mOffset(0), mSize(0), mLoaded(false), mLoadErr(OK) {}
 
     virtual void attachTo(ImageItem &/*image*/) const {
         ALOGW("Unrecognized property");
@@ -694,7 +701,27 @@ struct ItemProperty : public RefBase {
         return OK;
     }
 
+    // Remember where the property box is, it's only parsed by load() when
+    // the property is first attached to an item.
+    void setLocation(off64_t offset, size_t size) {
+        mOffset = offset;
+        mSize = size;
+    }
+
+    status_t load() {
+        if (!mLoaded) {
+            mLoadErr = parse(mOffset, mSize);
+            mLoaded = true;
+        }
+        return mLoadErr;
+    }
+
 private:
+    off64_t mOffset;
+    size_t mSize;
+    bool mLoaded;
+    status_t mLoadErr;
+
     DISALLOW_EVIL_CONSTRUCTORS(ItemProperty);
 };
 
@@ -1058,10 +1085,7 @@ status_t IpcoBox::onChunkData(uint32_t type, off64_t offset, size_t size) {
             break;
         }
     }
-    status_t err = itemProperty->parse(offset, size);
-    if (err != OK) {
-        return err;
-    }
+    itemProperty->setLocation(offset, size);
     mItemProperties->push_back(itemProperty);
     return OK;
 }
@@ -1464,6 +1488,7 @@ status_t ItemTable::buildImageItemsIfPossible(uint32_t type) {
 
     ALOGV("building image table...");
 
+    mItemIdToItemMap.setCapacity(mItemInfos.size());
     for (size_t i = 0; i < mItemInfos.size(); i++) {
         const ItemInfo &info = mItemInfos[i];
 
@@ -1514,29 +1539,24 @@ status_t ItemTable::buildImageItemsIfPossible(uint32_t type) {
 
         ALOGV("adding %s: itemId %d", image.isGrid() ? "grid" : "image", info.itemId);
 
-        if (image.isGrid()) {
-            // ImageGrid struct is at least 8-byte, at most 12-byte (if flags&1)
-            if (size < 8 || size > 12) {
-                return ERROR_MALFORMED;
-            }
-            uint8_t buf[12];
-            if (!mDataSource->readAt(offset, buf, size)) {
-                return ERROR_IO;
-            }
-
-            image.rows = buf[2] + 1;
-            image.columns = buf[3] + 1;
-
-            ALOGV("rows %d, columans %d", image.rows, image.columns);
-        } else {
-            image.offset = offset;
-            image.size = size;
+        // ImageGrid struct is at least 8-byte, at most 12-byte (if flags&1),
+        // it's read when the grid is resolved.
+        if (image.isGrid() && (size < 8 || size > 12)) {
+            return ERROR_MALFORMED;
         }
+        image.offset = offset;
+        image.size = size;
         mItemIdToItemMap.add(info.itemId, image);
     }
 
     for (size_t i = 0; i < mAssociations.size(); i++) {
-        attachProperty(mAssociations[i]);
+        const AssociationEntry &association = mAssociations[i];
+        ssize_t itemIndex = mItemIdToItemMap.indexOfKey(association.itemId);
+
+        // ignore non-image items
+        if (itemIndex >= 0) {
+            mItemIdToItemMap.editValueAt(itemIndex).propertyIndices.push_back(association.index);
+        }
     }
 
     for (size_t i = 0; i < mItemReferences.size(); i++) {
@@ -1570,24 +1590,49 @@ status_t ItemTable::buildImageItemsIfPossible(uint32_t type) {
     return OK;
 }
 
-void ItemTable::attachProperty(const AssociationEntry &association) {
-    ssize_t itemIndex = mItemIdToItemMap.indexOfKey(association.itemId);
+status_t ItemTable::attachProperty(ImageItem &image, uint16_t propertyIndex) {
+    if (propertyIndex >= mItemProperties.size()) {
+        ALOGW("Ignoring invalid property index %d", propertyIndex);
+        return OK;
+    }
 
-    // ignore non-image items
-    if (itemIndex < 0) {
-        return;
+    ALOGV("attach property %d to item id %d)", propertyIndex, image.itemId);
+
+    const sp<ItemProperty> &property = mItemProperties[propertyIndex];
+    status_t err = property->load();
+    if (err != OK) {
+        return err;
     }
+    property->attachTo(image);
+    return OK;
+}
 
-    uint16_t propertyIndex = association.index;
-    if (propertyIndex >= mItemProperties.size()) {
-        ALOGW("Ignoring invalid property index %d", propertyIndex);
-        return;
+status_t ItemTable::resolveImageItem(ImageItem &image) {
+    if (image.resolved) {
+        return image.resolveErr;
     }
+    image.resolved = true;
 
-    ALOGV("attach property %d to item id %d)",
-            propertyIndex, association.itemId);
+    for (size_t i = 0; i < image.propertyIndices.size(); i++) {
+        image.resolveErr = attachProperty(image, image.propertyIndices[i]);
+        if (image.resolveErr != OK) {
+            return image.resolveErr;
+        }
+    }
+
+    if (image.isGrid()) {
+        uint8_t buf[12];
+        if (!mDataSource->readAt(image.offset, buf, image.size)) {
+            image.resolveErr = ERROR_IO;
+            return image.resolveErr;
+        }
+
+        image.rows = buf[2] + 1;
+        image.columns = buf[3] + 1;
 
-    mItemProperties[propertyIndex]->attachTo(mItemIdToItemMap.editValueAt(itemIndex));
+        ALOGV("rows %d, columans %d", image.rows, image.columns);
+    }
+    return OK;
 }
 
 uint32_t ItemTable::countImages() const {
@@ -1606,6 +1651,9 @@ AMediaFormat *ItemTable::getImageMeta(const uint32_t imageIndex) {
     const uint32_t itemIndex = mDisplayables[imageIndex];
     ALOGV("image[%u]: item index %u", imageIndex, itemIndex);
 
+    if (resolveImageItem(mItemIdToItemMap.editValueAt(itemIndex)) != OK) {
+        return NULL;
+    }
     const ImageItem *image = &mItemIdToItemMap[itemIndex];
 
     ssize_t tileItemIndex = -1;
@@ -1614,7 +1662,8 @@ AMediaFormat *ItemTable::getImageMeta(const uint32_t imageIndex) {
             return NULL;
         }
         tileItemIndex = mItemIdToItemMap.indexOfKey(image->dimgRefs[0]);
-        if (tileItemIndex < 0) {
+        if (tileItemIndex < 0
+                || resolveImageItem(mItemIdToItemMap.editValueAt(tileItemIndex)) != OK) {
             return NULL;
         }
     }
@@ -1657,8 +1706,9 @@ AMediaFormat *ItemTable::getImageMeta(const uint32_t imageIndex) {
     if (!image->thumbnails.empty()) {
         ssize_t thumbItemIndex = mItemIdToItemMap.indexOfKey(image->thumbnails[0]);
         if (thumbItemIndex >= 0) {
-            const ImageItem &thumbnail = mItemIdToItemMap[thumbItemIndex];
-            if (thumbnail.hvcc != NULL || thumbnail.av1c != NULL) {
+            ImageItem &thumbnail = mItemIdToItemMap.editValueAt(thumbItemIndex);
+            if (resolveImageItem(thumbnail) == OK
+                    && (thumbnail.hvcc != NULL || thumbnail.av1c != NULL)) {
                 AMediaFormat_setInt32(meta,
                         AMEDIAFORMAT_KEY_THUMBNAIL_WIDTH, thumbnail.width);
                 AMediaFormat_setInt32(meta,
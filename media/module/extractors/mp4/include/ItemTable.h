@@ -95,7 +95,8 @@ private:
     status_t parseIdatBox(off64_t offset, size_t size);
     status_t parseIrefBox(off64_t offset, size_t size);
 
-    void attachProperty(const AssociationEntry &association);
+    status_t attachProperty(ImageItem &image, uint16_t propertyIndex);
+    status_t resolveImageItem(ImageItem &image);
     status_t buildImageItemsIfPossible(uint32_t type);
 
     DISALLOW_EVIL_CONSTRUCTORS(ItemTable);
@@ -130,18 +130,25 @@ protected:
 
     off64_t mFirstDataOffset;
 
+    // Size and duration of the stream, when it is cheap to read its last page;
+    // mFileSize is -1 otherwise and seeking falls back to the average bitrate.
+    off64_t mFileSize;
+    int64_t mDurationUs;
+
     vorbis_info mVi;
     vorbis_comment mVc;
 
     AMediaFormat *mMeta;
     AMediaFormat *mFileMeta;
 
+    // Sparse index of data pages discovered by previous seeks, sorted by offset.
     Vector<TOCEntry> mTableOfContents;
 
     int32_t mHapticChannelCount;
 
     ssize_t readPage(off64_t offset, Page *page);
-    status_t findNextPage(off64_t startOffset, off64_t *pageOffset);
+    // quiet: don't log skipped junk, for lookups that land mid page by design.
+    status_t findNextPage(off64_t startOffset, off64_t *pageOffset, bool quiet = false);
 
     virtual int64_t getTimeUsOfGranule(uint64_t granulePos) const = 0;
 
@@ -168,7 +175,10 @@ protected:
 
     status_t findPrevGranulePosition(off64_t pageOffset, uint64_t *granulePos);
 
-    void buildTableOfContents();
+    status_t findTimedPage(off64_t startOffset, off64_t endOffset,
+            off64_t *pageOffset, int64_t *timeUs);
+    status_t findPageForTime(int64_t timeUs, off64_t *pageOffset);
+    void addTOCEntry(off64_t pageOffset, int64_t timeUs);
 
     void setChannelMask(int channelCount);
 
@@ -324,6 +334,8 @@ MyOggExtractor::MyOggExtractor(
       mNumHeaders(numHeaders),
       mSeekPreRollUs(seekPreRollUs),
       mFirstDataOffset(-1),
+      mFileSize(-1),
+      mDurationUs(0),
       mHapticChannelCount(0) {
     mCurrentPage.mNumSegments = 0;
     mCurrentPage.mFlags = 0;
@@ -346,7 +358,7 @@ media_status_t MyOggExtractor::getFormat(AMediaFormat *meta) const {
 }
 
 status_t MyOggExtractor::findNextPage(
-        off64_t startOffset, off64_t *pageOffset) {
+        off64_t startOffset, off64_t *pageOffset, bool quiet) {
     *pageOffset = startOffset;
 
     // balance between larger reads and reducing how much we over-read.
@@ -374,7 +386,7 @@ status_t MyOggExtractor::findNextPage(
             i += jump;
             if (memcmp("OggS", &signatureBuffer[i], lenOggS) == 0) {
                 *pageOffset += i;
-                if (*pageOffset > startOffset) {
+                if (*pageOffset > startOffset && !quiet) {
                     ALOGD("skipped %" PRIu64 " bytes of junk to reach next frame",
                          (*pageOffset - startOffset));
                 }
@@ -493,7 +505,7 @@ status_t MyOggExtractor::seekToTime(int64_t timeUs) {
         timeUs = 0;
     }
 
-    if (mTableOfContents.isEmpty()) {
+    if (mFileSize < 0) {
         // Perform approximate seeking based on avg. bitrate.
         uint64_t bps = approxBitrate();
         if (bps <= 0) {
@@ -506,33 +518,182 @@ status_t MyOggExtractor::seekToTime(int64_t timeUs) {
         return seekToOffset(pos);
     }
 
-    size_t left = 0;
-    size_t right_plus_one = mTableOfContents.size();
-    while (left < right_plus_one) {
-        size_t center = left + (right_plus_one - left) / 2;
+    off64_t pageOffset;
+    status_t err = findPageForTime(timeUs, &pageOffset);
+    if (err != OK) {
+        return err;
+    }
+
+    ALOGV("seeking to page at offset %lld, %zu pages indexed",
+         (long long)pageOffset, mTableOfContents.size());
+
+    return seekToOffset(pageOffset);
+}
+
+// Granule position of a page on which no packet ends.
+static const uint64_t kNoGranulePosition = UINT64_MAX;
 
-        const TOCEntry &entry = mTableOfContents.itemAt(center);
+// Find the first page at or after startOffset, and before endOffset, that carries
+// a granule position, and return its offset and time.
+status_t MyOggExtractor::findTimedPage(off64_t startOffset, off64_t endOffset,
+        off64_t *pageOffset, int64_t *timeUs) {
+    off64_t offset = startOffset;
+    Page page;
+    // Bisection probes land at arbitrary offsets, skipping part of a page is expected.
+    while (findNextPage(offset, pageOffset, true /* quiet */) == OK
+            && *pageOffset < endOffset) {
+        ssize_t n = readPage(*pageOffset, &page);
+        if (n <= 0) {
+            // "OggS" inside packet data rather than a page header; keep looking.
+            offset = *pageOffset + 1;
+            continue;
+        }
+        if (page.mGranulePosition != kNoGranulePosition) {
+            *timeUs = getTimeUsOfGranule(page.mGranulePosition);
+            return OK;
+        }
+        offset = *pageOffset + n;
+    }
+    return ERROR_END_OF_STREAM;
+}
+
+// Find the first data page whose granule position maps to a time at or past timeUs,
+// or the last page of the stream if there is none.
+//
+// Rather than reading every page header at open time, the range known to contain
+// that page is narrowed by probing: interpolating on time between the closest known
+// pages, or bisecting when interpolation doesn't at least halve the range. Pages
+// found along the way are cached in mTableOfContents, so later seeks start from a
+// tighter range. Once the range is small, its pages are walked one by one.
+status_t MyOggExtractor::findPageForTime(int64_t timeUs, off64_t *pageOffset) {
+    // Below this many bytes, reading the remaining page headers in sequence is
+    // cheaper than another probe.
+    static const off64_t kLinearScanBytes = 64 * 1024;
+    static const size_t kMaxProbes = 64;
+
+    // Invariant: the page we are looking for starts in [lo.mPageOffset, hi.mPageOffset],
+    // and hi is either a page whose time is at or past timeUs or the end of the stream.
+    TOCEntry lo = { mFirstDataOffset, 0 };
+    TOCEntry hi = { mFileSize, mDurationUs };
 
-        if (timeUs < entry.mTimeUs) {
-            right_plus_one = center;
-        } else if (timeUs > entry.mTimeUs) {
+    size_t left = 0;
+    size_t right = mTableOfContents.size();
+    while (left < right) {
+        size_t center = left + (right - left) / 2;
+        if (mTableOfContents.itemAt(center).mTimeUs < timeUs) {
             left = center + 1;
         } else {
-            left = center;
+            right = center;
+        }
+    }
+    if (left < mTableOfContents.size()) {
+        hi = mTableOfContents.itemAt(left);
+    }
+    if (left > 0) {
+        lo = mTableOfContents.itemAt(left - 1);
+    }
+
+    bool bisect = false;
+    for (size_t probes = 0;
+            hi.mPageOffset - lo.mPageOffset > kLinearScanBytes && probes < kMaxProbes;
+            ++probes) {
+        const off64_t span = hi.mPageOffset - lo.mPageOffset;
+        off64_t probe;
+        if (!bisect && hi.mTimeUs > lo.mTimeUs) {
+            double fraction = (double)(timeUs - lo.mTimeUs) / (hi.mTimeUs - lo.mTimeUs);
+            probe = lo.mPageOffset + (off64_t)(fraction * span);
+        } else {
+            probe = lo.mPageOffset + span / 2;
+        }
+        if (probe <= lo.mPageOffset) {
+            probe = lo.mPageOffset + 1;
+        } else if (probe >= hi.mPageOffset) {
+            probe = hi.mPageOffset - 1;
+        }
+
+        off64_t foundOffset;
+        int64_t foundTimeUs;
+        if (findTimedPage(probe, hi.mPageOffset, &foundOffset, &foundTimeUs) != OK) {
+            if (bisect) {
+                // No usable page in the upper half either; scan what's left.
+                break;
+            }
+            bisect = true;
+            continue;
+        }
+        if (foundTimeUs < lo.mTimeUs || foundTimeUs > hi.mTimeUs) {
+            // Granule positions are not monotonic here (corrupt or chained stream);
+            // don't trust interpolation or the index for this range.
+            ALOGW("non-monotonic granule position at offset %lld", (long long)foundOffset);
             break;
         }
+        addTOCEntry(foundOffset, foundTimeUs);
+
+        if (foundTimeUs < timeUs) {
+            lo.mPageOffset = foundOffset;
+            lo.mTimeUs = foundTimeUs;
+        } else {
+            hi.mPageOffset = foundOffset;
+            hi.mTimeUs = foundTimeUs;
+        }
+        bisect = (hi.mPageOffset - lo.mPageOffset) * 2 > span;
+    }
+
+    off64_t offset = lo.mPageOffset;
+    off64_t lastTimedOffset = -1;
+    Page page;
+    ssize_t n;
+    while (offset < hi.mPageOffset && (n = readPage(offset, &page)) > 0) {
+        if (page.mGranulePosition != kNoGranulePosition) {
+            if (getTimeUsOfGranule(page.mGranulePosition) >= timeUs) {
+                *pageOffset = offset;
+                return OK;
+            }
+            lastTimedOffset = offset;
+        }
+        offset += n;
     }
 
-    if (left == mTableOfContents.size()) {
-        --left;
+    if (hi.mPageOffset < mFileSize) {
+        *pageOffset = hi.mPageOffset;
+    } else if (lastTimedOffset >= 0) {
+        // Seeking past the last page, go to the last page.
+        *pageOffset = lastTimedOffset;
+    } else {
+        *pageOffset = lo.mPageOffset;
     }
+    return OK;
+}
 
-    const TOCEntry &entry = mTableOfContents.itemAt(left);
+void MyOggExtractor::addTOCEntry(off64_t pageOffset, int64_t timeUs) {
+    // Limit the maximum amount of RAM we spend on the table of contents;
+    // once full, later seeks simply probe a little more.
+    static const size_t kMaxTOCSize = 8192;
+    static const size_t kMaxNumTOCEntries = kMaxTOCSize / sizeof(TOCEntry);
 
-    ALOGV("seeking to entry %zu / %zu at offset %lld",
-         left, mTableOfContents.size(), (long long)entry.mPageOffset);
+    if (mTableOfContents.size() >= kMaxNumTOCEntries) {
+        return;
+    }
 
-    return seekToOffset(entry.mPageOffset);
+    size_t left = 0;
+    size_t right = mTableOfContents.size();
+    while (left < right) {
+        size_t center = left + (right - left) / 2;
+        if (mTableOfContents.itemAt(center).mPageOffset < pageOffset) {
+            left = center + 1;
+        } else {
+            right = center;
+        }
+    }
+    if (left < mTableOfContents.size()
+            && mTableOfContents.itemAt(left).mPageOffset == pageOffset) {
+        return;
+    }
+
+    TOCEntry entry;
+    entry.mPageOffset = pageOffset;
+    entry.mTimeUs = timeUs;
+    mTableOfContents.insertAt(entry, left);
 }
 
 status_t MyOggExtractor::seekToOffset(off64_t offset) {
@@ -1016,56 +1177,14 @@ status_t MyOggExtractor::init() {
 
         AMediaFormat_setInt64(mMeta, AMEDIAFORMAT_KEY_DURATION, durationUs);
 
-        buildTableOfContents();
+        // The table of contents is filled in lazily by seekToTime().
+        mFileSize = size;
+        mDurationUs = durationUs;
     }
 
     return AMEDIA_OK;
 }
 
-void MyOggExtractor::buildTableOfContents() {
-    off64_t offset = mFirstDataOffset;
-    Page page;
-    ssize_t pageSize;
-    while ((pageSize = readPage(offset, &page)) > 0) {
-        mTableOfContents.push();
-
-        TOCEntry &entry =
-            mTableOfContents.editItemAt(mTableOfContents.size() - 1);
-
-        entry.mPageOffset = offset;
-        entry.mTimeUs = getTimeUsOfGranule(page.mGranulePosition);
-
-        offset += (size_t)pageSize;
-    }
-
-    // Limit the maximum amount of RAM we spend on the table of contents,
-    // if necessary thin out the table evenly to trim it down to maximum
-    // size.
-
-    static const size_t kMaxTOCSize = 8192;
-    static const size_t kMaxNumTOCEntries = kMaxTOCSize / sizeof(TOCEntry);
-
-    size_t numerator = mTableOfContents.size();
-
-    if (numerator > kMaxNumTOCEntries) {
-        Vector<TOCEntry> maxTOC;
-        maxTOC.setCapacity(kMaxNumTOCEntries);
-
-        size_t denom = numerator - kMaxNumTOCEntries;
-        size_t accum = 0;
-        for (ssize_t i = 0; i < mTableOfContents.size(); i++) {
-            accum += denom;
-            if (accum >= numerator) {
-                accum -= numerator;
-            } else {
-                maxTOC.push(mTableOfContents.itemAt(i));
-            }
-        }
-
-        mTableOfContents = maxTOC;
-    }
-}
-
 int32_t MyOggExtractor::getPacketBlockSize(MediaBufferHelper *buffer) {
     const uint8_t *data =
         (const uint8_t *)buffer->data() + buffer->range_offset();
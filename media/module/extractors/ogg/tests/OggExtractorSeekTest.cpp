@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <OggExtractor.h>
+#include <gtest/gtest.h>
+#include <media/MediaExtractorPluginHelper.h>
+#include <media/NdkMediaFormat.h>
+#include <media/stagefright/MediaBufferGroup.h>
+
+namespace {
+
+using namespace android;
+
+constexpr uint16_t kPreSkip = 312;
+constexpr int kSampleRate = 48000;
+constexpr uint64_t kSamplesPerPacket = 960;  // TOC config 31: CELT fullband, 20 ms
+constexpr int64_t kSeekPreRollUs = 80000;
+constexpr uint64_t kNoGranulePosition = UINT64_MAX;
+
+class BufferSource : public DataSourceHelper {
+public:
+    explicit BufferSource(const std::vector<uint8_t> &data)
+        : DataSourceHelper((CDataSource *)nullptr), mData(data) {}
+
+    ssize_t readAt(off64_t offset, void *data, size_t size) override {
+        if (offset < 0 || offset >= (off64_t)mData.size()) {
+            return 0;
+        }
+        size = std::min(size, (size_t)(mData.size() - offset));
+        memcpy(data, mData.data() + offset, size);
+        return size;
+    }
+
+    status_t getSize(off64_t *size) override {
+        *size = mData.size();
+        return OK;
+    }
+
+    uint32_t flags() override { return 0; }
+
+private:
+    const std::vector<uint8_t> &mData;
+};
+
+// A single Opus stream, paginated the way muxers do: pages end at arbitrary lacing
+// values, so packets continue across pages and some pages end no packet at all.
+class OpusStream {
+public:
+    struct Page {
+        off64_t mOffset;
+        uint64_t mGranulePosition;
+    };
+
+    std::vector<uint8_t> mData;
+    std::vector<Page> mDataPages;
+
+    OpusStream(size_t numPackets, uint32_t seed) {
+        std::mt19937 rng(seed);
+
+        const uint8_t head[] = {
+            'O', 'p', 'u', 's', 'H', 'e', 'a', 'd',
+            1,                                   // version
+            2,                                   // channels
+            kPreSkip & 0xff, kPreSkip >> 8,      // pre-skip
+            0x80, 0xbb, 0, 0,                    // input sample rate: 48000
+            0, 0,                                // output gain
+            0,                                   // channel mapping family
+        };
+        addPacket(head, sizeof(head), 0);
+        flushPage(0x02 /* first page */);
+
+        const uint8_t tags[] = {
+            'O', 'p', 'u', 's', 'T', 'a', 'g', 's',
+            4, 0, 0, 0, 't', 'e', 's', 't',      // vendor string
+            0, 0, 0, 0,                          // no comments
+        };
+        addPacket(tags, sizeof(tags), 0);
+        flushPage(0);
+
+        size_t pageBytes = 4000;
+        std::vector<uint8_t> packet;
+        for (size_t i = 0; i < numPackets; ++i) {
+            // Mostly typical sizes, with the odd packet larger than a page. The first
+            // page only holds small ones, for the stream start time to be found.
+            size_t size = 1 + rng() % 1500;
+            if (i < 8) {
+                size = 1 + rng() % 200;
+            } else if (rng() % 20 == 0) {
+                size = 5000 + rng() % 10000;
+            }
+            packet.resize(size);
+            packet[0] = 31 << 3;  // one 20 ms frame
+            for (size_t j = 1; j < size; ++j) {
+                // Nothing that could be mistaken for a capture pattern.
+                packet[j] = 'a' + rng() % 26;
+            }
+
+            // Pages closed while lacing this packet don't count it yet.
+            addPacket(packet.data(), size, pageBytes);
+            mSamples += kSamplesPerPacket;
+            if (mBody.size() >= pageBytes) {
+                flushPage(0);
+                pageBytes = 500 + rng() % 8000;
+            }
+        }
+        flushPage(0x04 /* last page */);
+    }
+
+    int64_t timeUsOfPage(size_t index) const {
+        return (mDataPages[index].mGranulePosition - kPreSkip) * 1000000ll / kSampleRate;
+    }
+
+    // The page a full scan picks for a seek to timeUs: the first one ending a packet
+    // at or past the target, or the last page ending a packet.
+    size_t timedPageForSeek(int64_t timeUs) const {
+        timeUs = std::max(timeUs - kSeekPreRollUs, (int64_t)0);
+        size_t timedPage = 0;
+        for (const Page &page : mDataPages) {
+            if (page.mGranulePosition == kNoGranulePosition) {
+                continue;
+            }
+            if ((int64_t)((page.mGranulePosition - kPreSkip) * 1000000ll / kSampleRate)
+                    >= timeUs) {
+                return timedPage;
+            }
+            ++timedPage;
+        }
+        return timedPage - 1;
+    }
+
+    size_t numTimedPages() const {
+        return std::count_if(mDataPages.begin(), mDataPages.end(), [](const Page &page) {
+            return page.mGranulePosition != kNoGranulePosition;
+        });
+    }
+
+private:
+    std::vector<uint8_t> mLacing;
+    std::vector<uint8_t> mBody;
+    uint64_t mSamples = 0;
+    uint32_t mPageNo = 0;
+    // Whether the current page starts with the rest of a packet, and ends any.
+    bool mContinued = false;
+    bool mEndsPacket = false;
+
+    // Lace a packet onto the current page, closing pages on the way if they fill up
+    // or grow past maxPageBytes (when non zero).
+    void addPacket(const uint8_t *data, size_t size, size_t maxPageBytes) {
+        size_t offset = 0;
+        for (;;) {
+            if (mLacing.size() == 255
+                    || (maxPageBytes > 0 && mBody.size() >= maxPageBytes)) {
+                flushPage(0);
+                mContinued = offset > 0;
+            }
+            size_t lace = std::min(size - offset, (size_t)255);
+            mLacing.push_back(lace);
+            mBody.insert(mBody.end(), data + offset, data + offset + lace);
+            offset += lace;
+            if (lace < 255) {
+                mEndsPacket = true;
+                return;
+            }
+        }
+    }
+
+    void flushPage(uint8_t flags) {
+        if (mLacing.empty()) {
+            return;
+        }
+        uint64_t granulePosition = mEndsPacket ? mSamples : kNoGranulePosition;
+        if (mPageNo >= 2) {
+            mDataPages.push_back({(off64_t)mData.size(), granulePosition});
+        }
+        uint8_t header[27] = {'O', 'g', 'g', 'S', 0 /* version */};
+        header[5] = flags | (mContinued ? 0x01 : 0);
+        for (int i = 0; i < 8; ++i) {
+            header[6 + i] = granulePosition >> (8 * i);
+        }
+        header[14] = 0x17;  // serial number
+        for (int i = 0; i < 4; ++i) {
+            header[18 + i] = mPageNo >> (8 * i);
+        }
+        // The extractor doesn't check the CRC, leave it zero.
+        header[26] = mLacing.size();
+        mData.insert(mData.end(), header, header + sizeof(header));
+        mData.insert(mData.end(), mLacing.begin(), mLacing.end());
+        mData.insert(mData.end(), mBody.begin(), mBody.end());
+
+        mLacing.clear();
+        mBody.clear();
+        mContinued = false;
+        mEndsPacket = false;
+        ++mPageNo;
+    }
+};
+
+class OggExtractorSeekTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        mExtractor = new OggExtractor(new BufferSource(mStream.mData));
+        ASSERT_EQ(1u, mExtractor->countTracks());
+        mTrack = mExtractor->getTrack(0);
+        ASSERT_NE(nullptr, mTrack);
+        mCTrack = wrap(mTrack);
+        ASSERT_EQ(AMEDIA_OK, mCTrack->start(mTrack, mBufferGroup.wrap()));
+    }
+
+    void TearDown() override {
+        if (mCTrack != nullptr) {
+            mCTrack->stop(mTrack);
+            mCTrack->free(mTrack);
+            free(mCTrack);
+        }
+        delete mExtractor;
+    }
+
+    // Reads one buffer, seeking first if seekTimeUs is not negative. Returns its time
+    // and whether it is the first packet ending on its page.
+    void read(int64_t seekTimeUs, int64_t *timeUs, bool *firstOnPage, media_status_t *err) {
+        MediaTrackHelper::ReadOptions options(
+                seekTimeUs >= 0
+                        ? CMediaTrackReadOptions::SEEK | CMediaTrackReadOptions::SEEK_CLOSEST
+                        : 0,
+                seekTimeUs);
+        MediaBufferHelper *buffer = nullptr;
+        *err = mTrack->read(&buffer, &options);
+        if (*err != AMEDIA_OK) {
+            return;
+        }
+        AMediaFormat *meta = buffer->meta_data();
+        int32_t validSamples;
+        ASSERT_TRUE(AMediaFormat_getInt64(meta, AMEDIAFORMAT_KEY_TIME_US, timeUs));
+        *firstOnPage = AMediaFormat_getInt32(meta, AMEDIAFORMAT_KEY_VALID_SAMPLES, &validSamples);
+        buffer->release();
+    }
+
+    OpusStream mStream{6000, 1};
+    MediaExtractorPluginHelper *mExtractor = nullptr;
+    MediaTrackHelper *mTrack = nullptr;
+    CMediaTrack *mCTrack = nullptr;
+    MediaBufferGroup mBufferGroup;
+};
+
+// Seeking must land on the page a full scan picks, whatever the order of the seeks
+// and so whatever pages earlier seeks happened to index.
+TEST_F(OggExtractorSeekTest, SeekMatchesFullScan) {
+    // Large enough for seeks to probe rather than walk every page header.
+    ASSERT_GT(mStream.mData.size(), 4u * 1024 * 1024);
+
+    // Read through once: the first packet ending on each page carries the time the
+    // extractor gives that page when it starts reading from there.
+    std::vector<int64_t> pageTimesUs;
+    media_status_t err;
+    for (;;) {
+        int64_t timeUs;
+        bool firstOnPage;
+        read(-1, &timeUs, &firstOnPage, &err);
+        if (err != AMEDIA_OK) {
+            break;
+        }
+        if (firstOnPage) {
+            pageTimesUs.push_back(timeUs);
+        }
+    }
+    ASSERT_EQ(AMEDIA_ERROR_END_OF_STREAM, err);
+    ASSERT_EQ(mStream.numTimedPages(), pageTimesUs.size());
+
+    const int64_t durationUs = mStream.timeUsOfPage(mStream.mDataPages.size() - 1);
+    std::vector<int64_t> seekTimesUs;
+    for (int64_t timeUs = 0; timeUs < durationUs + 1000000; timeUs += 123457) {
+        seekTimesUs.push_back(timeUs);
+    }
+    std::shuffle(seekTimesUs.begin(), seekTimesUs.end(), std::mt19937(2));
+
+    for (int64_t seekTimeUs : seekTimesUs) {
+        int64_t timeUs;
+        bool firstOnPage;
+        read(seekTimeUs, &timeUs, &firstOnPage, &err);
+        ASSERT_EQ(AMEDIA_OK, err) << "seek to " << seekTimeUs;
+        EXPECT_TRUE(firstOnPage) << "seek to " << seekTimeUs;
+        EXPECT_EQ(pageTimesUs[mStream.timedPageForSeek(seekTimeUs)], timeUs)
+                << "seek to " << seekTimeUs;
+    }
+}
+
+}  // namespace
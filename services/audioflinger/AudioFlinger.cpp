@@ -61,6 +61,7 @@
 
 // not needed with the includes above, added to prevent transitive include dependency.
 #include <chrono>
+#include <inttypes.h>
 #include <thread>
 
 // ----------------------------------------------------------------------------
@@ -718,6 +719,11 @@ void AudioFlinger::dumpInternals_l(int fd, const Vector<String16>& args __unused
     }
     dprintf(fd, "Bluetooth latency modes are %senabled\n",
             mBluetoothLatencyModesEnabled ? "" : "not ");
+
+    uint64_t policyQueryHits, policyQueryMisses;
+    AudioSystem::getPolicyQueryCacheStats(&policyQueryHits, &policyQueryMisses);
+    dprintf(fd, "Audio policy query cache: %" PRIu64 " hits, %" PRIu64 " misses\n",
+            policyQueryHits, policyQueryMisses);
 }
 
 void AudioFlinger::dumpPermissionDenial(int fd, const Vector<String16>& args __unused)
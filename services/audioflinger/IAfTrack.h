@@ -29,6 +29,8 @@
 #include <utils/RefBase.h>
 #include <vibrator/ExternalVibration.h>
 
+#include <memory>
+#include <string.h>
 #include <vector>
 
 namespace android {
@@ -425,6 +427,57 @@ public:
     virtual FastTrackUnderruns& fastTrackUnderruns() = 0;
 };
 
+// One mix cycle of a DuplicatingThread, fanned out to all of its OutputTracks.
+//
+// OutputTracks normally copy straight from the mix into their destination track buffer.
+// When a destination cannot accept the whole cycle, the remainder must be kept for the
+// next write(). Rather than each lagging OutputTrack allocating and copying its own
+// overflow buffer, the mix is snapshotted at most once per cycle into reference-counted
+// storage and all lagging OutputTracks share it, each with its own read position.
+// The storage is recycled across cycles once no OutputTrack references it any longer.
+//
+// Only used on the DuplicatingThread threadLoop, hence not thread safe.
+class DuplicatedMixBuffer {
+public:
+    // Storage recycled by the owner (the DuplicatingThread) across cycles.
+    struct Storage {
+        std::shared_ptr<int8_t> data;
+        size_t capacity = 0;
+        size_t snapshots = 0;    // number of cycles copied, for dump
+    };
+
+    DuplicatedMixBuffer(const void* data, uint32_t frames, size_t frameSize, Storage& storage)
+        : mData(data), mFrames(frames), mFrameSize(frameSize), mStorage(storage) {}
+
+    const void* data() const { return mData; }
+    uint32_t frames() const { return mFrames; }
+
+    // Returns a reference-counted copy of the mix, created on the first call in the cycle.
+    std::shared_ptr<const int8_t> snapshot() {
+        if (mSnapshot == nullptr) {
+            const size_t bytes = mFrames * mFrameSize;
+            // Reuse the previous cycle's storage if no OutputTrack still holds it.
+            if (mStorage.data == nullptr || mStorage.data.use_count() != 1
+                    || mStorage.capacity < bytes) {
+                mStorage.data = std::shared_ptr<int8_t>(
+                        new int8_t[bytes], std::default_delete<int8_t[]>());
+                mStorage.capacity = bytes;
+            }
+            memcpy(mStorage.data.get(), mData, bytes);
+            ++mStorage.snapshots;
+            mSnapshot = mStorage.data;
+        }
+        return mSnapshot;
+    }
+
+private:
+    const void* const mData;
+    const uint32_t mFrames;
+    const size_t mFrameSize;
+    Storage& mStorage;
+    std::shared_ptr<const int8_t> mSnapshot;
+};
+
 // playback track, used by DuplicatingThread
 class IAfOutputTrack : public virtual IAfTrack {
 public:
@@ -434,7 +487,9 @@ public:
             audio_format_t format, audio_channel_mask_t channelMask, size_t frameCount,
             const AttributionSourceState& attributionSource);
 
-    virtual ssize_t write(void* data, uint32_t frames) = 0;
+    // Writes one mix cycle; frames not accepted by the destination are kept by
+    // reference to the shared snapshot of the cycle (see DuplicatedMixBuffer).
+    virtual ssize_t write(DuplicatedMixBuffer& mix) = 0;
     virtual bool bufferQueueEmpty() const = 0;
     virtual bool isActive() const = 0;
 
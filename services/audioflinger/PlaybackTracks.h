@@ -24,6 +24,8 @@
 #include <audio_utils/LinearMap.h>
 #include <binder/AppOpsManager.h>
 
+#include <deque>
+
 namespace android {
 
 // Checks and monitors OP_PLAY_AUDIO
@@ -404,7 +406,9 @@ public:
 
     class Buffer : public AudioBufferProvider::Buffer {
     public:
-        void *mBuffer;
+        // Keeps alive the mix cycle snapshot that raw points into,
+        // possibly shared with the other OutputTracks of the DuplicatingThread.
+        std::shared_ptr<const int8_t> mBuffer;
     };
 
     OutputTrack(IAfPlaybackThread* thread,
@@ -420,8 +424,8 @@ public:
                                     AudioSystem::SYNC_EVENT_NONE,
                              audio_session_t triggerSession = AUDIO_SESSION_NONE) final;
     void stop() final;
-    ssize_t write(void* data, uint32_t frames) final;
-    bool bufferQueueEmpty() const final { return mBufferQueue.size() == 0; }
+    ssize_t write(DuplicatedMixBuffer& mix) final;
+    bool bufferQueueEmpty() const final { return mBufferQueue.empty(); }
     bool isActive() const final { return mActive; }
 
     void copyMetadataTo(MetadataInserter& backInserter) const final;
@@ -442,7 +446,7 @@ public:
 private:
     status_t            obtainBuffer(AudioBufferProvider::Buffer* buffer,
                                      uint32_t waitTimeMs);
-    void                queueBuffer(Buffer& inBuffer);
+    void                queueBuffer(Buffer& inBuffer, DuplicatedMixBuffer& mix);
     void                clearBufferQueue();
 
     void                restartIfDisabled();
@@ -450,7 +454,7 @@ private:
     // Maximum number of pending buffers allocated by OutputTrack::write()
     static const uint8_t kMaxOverFlowBuffers = 10;
 
-    Vector < Buffer* >          mBufferQueue;
+    std::deque<Buffer>          mBufferQueue;
     AudioBufferProvider::Buffer mOutBuffer;
     bool                        mActive;
     IAfDuplicatingThread* const mSourceThread; // for waitTimeMs() in write()
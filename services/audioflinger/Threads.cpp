@@ -3894,6 +3894,27 @@ void PlaybackThread::detachAuxEffect_l(int effectId)
     }
 }
 
+// The thread type reported in this thread's NBLog entries.
+static NBLog::ThreadType nblogThreadType(IAfThreadBase::type_t type)
+{
+    switch (type) {
+    case IAfThreadBase::MIXER:
+        return NBLog::MIXER;
+    case IAfThreadBase::DIRECT:
+        return NBLog::DIRECT;
+    case IAfThreadBase::DUPLICATING:
+        return NBLog::DUPLICATING;
+    case IAfThreadBase::OFFLOAD:
+        return NBLog::OFFLOAD;
+    case IAfThreadBase::SPATIALIZER:
+        return NBLog::SPATIALIZER;
+    case IAfThreadBase::BIT_PERFECT:
+        return NBLog::BIT_PERFECT;
+    default:
+        return NBLog::UNKNOWN;
+    }
+}
+
 bool PlaybackThread::threadLoop()
 NO_THREAD_SAFETY_ANALYSIS  // manual locking of AudioFlinger
 {
@@ -3944,6 +3965,15 @@ NO_THREAD_SAFETY_ANALYSIS  // manual locking of AudioFlinger
     // See reference to logString below.
     const char *logString = NULL;
 
+    // Per-cycle timing is logged as typed entries rather than through a shared writer:
+    // each thread writes only to its own single-producer log, which is lock-free,
+    // and the MergeReader combines the per-thread logs on the reader side.
+    NBLog::thread_info_t nblogInfo;
+    nblogInfo.id = mId;
+    nblogInfo.type = nblogThreadType(mType);
+    LOG_THREAD_INFO(nblogInfo);
+    NBLog::thread_params_t nblogParams;
+
     // Estimated time for next buffer to be written to hal. This is used only on
     // suspended mode (for now) to help schedule the wait time until next iteration.
     nsecs_t timeLoopNextNs = 0;
@@ -4397,8 +4427,16 @@ NO_THREAD_SAFETY_ANALYSIS  // manual locking of AudioFlinger
                                         TimestampVerifier<int64_t, int64_t>::computeJitterMs(
                                                 {frames, writePeriodNs},
                                                 {0, 0} /* lastTimestamp */, mSampleRate);
-                                const double processMs =
-                                       (lastIoBeginNs - mLastIoEndNs) * 1e-6;
+                                const int64_t processNs = lastIoBeginNs - mLastIoEndNs;
+                                const double processMs = processNs * 1e-6;
+
+                                if (nblogParams.frameCount != mNormalFrameCount
+                                        || nblogParams.sampleRate != mSampleRate) {
+                                    nblogParams.frameCount = mNormalFrameCount;
+                                    nblogParams.sampleRate = mSampleRate;
+                                    LOG_THREAD_PARAMS(nblogParams);
+                                }
+                                LOG_WORK_TIME(processNs);
 
                                 audio_utils::lock_guard _l(mutex());
                                 mIoJitterMs.add(jitterMs);
@@ -7574,8 +7612,11 @@ void DuplicatingThread::threadLoop_sleepTime()
 
 ssize_t DuplicatingThread::threadLoop_write()
 {
+    // The mix is shared by all OutputTracks; it is only copied (once) if a destination
+    // cannot accept all of it.
+    DuplicatedMixBuffer mix(mSinkBuffer, writeFrames, mFrameSize, mMixStorage);
     for (size_t i = 0; i < outputTracks.size(); i++) {
-        const ssize_t actualWritten = outputTracks[i]->write(mSinkBuffer, writeFrames);
+        const ssize_t actualWritten = outputTracks[i]->write(mix);
 
         // Consider the first OutputTrack for timestamp and frame counting.
 
@@ -7646,6 +7687,7 @@ void DuplicatingThread::dumpInternals_l(int fd, const Vector<String16>& args)
         }
     }
     ss << "\n";
+    ss << "  Overflow mix snapshots: " << mMixStorage.snapshots << "\n";
     std::string result = ss.str();
     write(fd, result.c_str(), result.size());
 }
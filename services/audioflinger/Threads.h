@@ -1864,6 +1864,9 @@ private:
     // NO_THREAD_SAFETY_ANALYSIS  GUARDED_BY(ThreadBase_ThreadLoop)
     SortedVector <sp<IAfOutputTrack>> outputTracks;
     SortedVector <sp<IAfOutputTrack>> mOutputTracks GUARDED_BY(mutex());
+    // Recycled storage for mix cycles pending in OutputTrack overflow queues.
+    // NO_THREAD_SAFETY_ANALYSIS  GUARDED_BY(ThreadBase_ThreadLoop)
+    DuplicatedMixBuffer::Storage mMixStorage;
 public:
     virtual     bool        hasFastMixer() const { return false; }
                 status_t    threadloop_getHalTimestamp_l(
@@ -2205,8 +2205,9 @@ void OutputTrack::stop()
     mActive = false;
 }
 
-ssize_t OutputTrack::write(void* data, uint32_t frames)
+ssize_t OutputTrack::write(DuplicatedMixBuffer& mix)
 {
+    const uint32_t frames = mix.frames();
     if (!mActive && frames != 0) {
         const sp<IAfThreadBase> thread = mThread.promote();
         if (thread != nullptr && thread->inStandby()) {
@@ -2238,8 +2239,8 @@ ssize_t OutputTrack::write(void* data, uint32_t frames)
             // write() is called again and this buffer actually consumed.
             Buffer firstBuffer;
             firstBuffer.frameCount = frames;
-            firstBuffer.raw = data;
-            queueBuffer(firstBuffer);
+            firstBuffer.raw = const_cast<void*>(mix.data());
+            queueBuffer(firstBuffer, mix);
             return frames;
         } else {
             (void) start();
@@ -2249,12 +2250,12 @@ ssize_t OutputTrack::write(void* data, uint32_t frames)
     Buffer *pInBuffer;
     Buffer inBuffer;
     inBuffer.frameCount = frames;
-    inBuffer.raw = data;
+    inBuffer.raw = const_cast<void*>(mix.data());
     uint32_t waitTimeLeftMs = mSourceThread->waitTimeMs();
     while (waitTimeLeftMs) {
         // First write pending buffers, then new data
-        if (mBufferQueue.size()) {
-            pInBuffer = mBufferQueue.itemAt(0);
+        if (!mBufferQueue.empty()) {
+            pInBuffer = &mBufferQueue.front();
         } else {
             pInBuffer = &inBuffer;
         }
@@ -2299,12 +2300,9 @@ ssize_t OutputTrack::write(void* data, uint32_t frames)
         mOutBuffer.raw = (int8_t *)mOutBuffer.raw + outFrames * mFrameSize;
 
         if (pInBuffer->frameCount == 0) {
-            if (mBufferQueue.size()) {
-                mBufferQueue.removeAt(0);
-                free(pInBuffer->mBuffer);
-                if (pInBuffer != &inBuffer) {
-                    delete pInBuffer;
-                }
+            if (pInBuffer != &inBuffer) {
+                // releases our reference to the shared snapshot of that cycle
+                mBufferQueue.pop_front();
                 ALOGV("%s(%d): thread %d released overflow buffer %zu",
                         __func__, mId,
                         (int)mThreadIoHandle, mBufferQueue.size());
@@ -2314,38 +2312,36 @@ ssize_t OutputTrack::write(void* data, uint32_t frames)
         }
     }
 
-    // If we could not write all frames, allocate a buffer and queue it for next time.
+    // If we could not write all frames, reference the remainder for next time.
     if (inBuffer.frameCount) {
         const sp<IAfThreadBase> thread = mThread.promote();
         if (thread != nullptr && !thread->inStandby()) {
-            queueBuffer(inBuffer);
+            queueBuffer(inBuffer, mix);
         }
     }
 
     // Calling write() with a 0 length buffer means that no more data will be written:
     // We rely on stop() to set the appropriate flags to allow the remaining frames to play out.
-    if (frames == 0 && mBufferQueue.size() == 0 && mActive) {
+    if (frames == 0 && mBufferQueue.empty() && mActive) {
         stop();
     }
 
     return frames - inBuffer.frameCount;  // number of frames consumed.
 }
 
-void OutputTrack::queueBuffer(Buffer& inBuffer) {
+void OutputTrack::queueBuffer(Buffer& inBuffer, DuplicatedMixBuffer& mix) {
 
     if (mBufferQueue.size() < kMaxOverFlowBuffers) {
-        Buffer *pInBuffer = new Buffer;
-        const size_t bufferSize = inBuffer.frameCount * mFrameSize;
-        pInBuffer->mBuffer = malloc(bufferSize);
-        LOG_ALWAYS_FATAL_IF(pInBuffer->mBuffer == nullptr,
-                "%s: Unable to malloc size %zu", __func__, bufferSize);
-        pInBuffer->frameCount = inBuffer.frameCount;
-        pInBuffer->raw = pInBuffer->mBuffer;
-        memcpy(pInBuffer->raw, inBuffer.raw, inBuffer.frameCount * mFrameSize);
-        mBufferQueue.add(pInBuffer);
+        // inBuffer points into the mix; keep the same position within the snapshot,
+        // which is copied at most once per cycle for all OutputTracks.
+        const size_t offset = (const int8_t*)inBuffer.raw - (const int8_t*)mix.data();
+        Buffer& pending = mBufferQueue.emplace_back();
+        pending.mBuffer = mix.snapshot();
+        pending.frameCount = inBuffer.frameCount;
+        pending.raw = const_cast<int8_t*>(pending.mBuffer.get()) + offset;
         ALOGV("%s(%d): thread %d adding overflow buffer %zu", __func__, mId,
                 (int)mThreadIoHandle, mBufferQueue.size());
-        // audio data is consumed (stored locally); set frameCount to 0.
+        // audio data is consumed (referenced locally); set frameCount to 0.
         inBuffer.frameCount = 0;
     } else {
         ALOGW("%s(%d): thread %d no more overflow buffers",
@@ -2385,13 +2381,6 @@ status_t OutputTrack::obtainBuffer(
 
 void OutputTrack::clearBufferQueue()
 {
-    size_t size = mBufferQueue.size();
-
-    for (size_t i = 0; i < size; i++) {
-        Buffer *pBuffer = mBufferQueue.itemAt(i);
-        free(pBuffer->mBuffer);
-        delete pBuffer;
-    }
     mBufferQueue.clear();
 }
 
@@ -626,13 +626,14 @@ void SoundDoseManager::onNewMelValues(const std::vector<float>& mels, size_t off
                 timestampSec - length));
 
         currentCsd = mMelAggregator->getCsd();
+        if (mSoundDose != nullptr) {
+            soundDoseCallback = mSoundDose->mSoundDoseCallback;
+        }
     }
 
-    soundDoseCallback = getSoundDoseCallback();
-
     if (records.size() > 0 && soundDoseCallback != nullptr) {
         std::vector<media::SoundDoseRecord> newRecordsToReport;
-        newRecordsToReport.resize(records.size());
+        newRecordsToReport.reserve(records.size());
         for (const auto& record : records) {
             newRecordsToReport.emplace_back(csdRecordToSoundDoseRecord(record));
         }
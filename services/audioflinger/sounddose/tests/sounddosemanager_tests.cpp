@@ -20,6 +20,7 @@
 #include <SoundDoseManager.h>
 
 #include <aidl/android/hardware/audio/core/sounddose/BnSoundDose.h>
+#include <android/media/BnSoundDoseCallback.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <media/AidlConversionCppNdk.h>
@@ -45,6 +46,13 @@ public:
     MOCK_METHOD(void, stopMelComputationForDeviceId, (audio_port_handle_t), (override));
 };
 
+class SoundDoseCallbackMock : public media::BnSoundDoseCallback {
+public:
+    MOCK_METHOD(binder::Status, onMomentaryExposure, (float, int32_t), (override));
+    MOCK_METHOD(binder::Status, onNewCsdValue,
+                (float, const std::vector<media::SoundDoseRecord>&), (override));
+};
+
 constexpr char kPrimaryModule[] = "primary";
 constexpr char kSecondaryModule[] = "secondary";
 
@@ -118,6 +126,30 @@ TEST_F(SoundDoseManagerTest, NewMelValuesCacheNewRecord) {
     EXPECT_EQ(mSoundDoseManager->getCachedMelRecordsSize(), size_t{1});
 }
 
+TEST_F(SoundDoseManagerTest, NewMelValuesReportOnlyComputedCsdRecords) {
+    sp<SoundDoseCallbackMock> callback = sp<SoundDoseCallbackMock>::make();
+    mSoundDoseManager->getSoundDoseInterface(callback);
+    std::vector<media::SoundDoseRecord> reportedRecords;
+    EXPECT_CALL(*callback.get(), onNewCsdValue)
+        .WillOnce([&reportedRecords] (float currentCsd,
+                                      const std::vector<media::SoundDoseRecord>& records) {
+            EXPECT_GT(currentCsd, 0.f);
+            reportedRecords = records;
+            return binder::Status::ok();
+        });
+    // loud enough to add to the sound dose
+    std::vector<float>mels(10, 100.f);
+
+    mSoundDoseManager->onNewMelValues(mels, 0, mels.size(), /*deviceId=*/1);
+
+    ASSERT_FALSE(reportedRecords.empty());
+    for (const auto& record : reportedRecords) {
+        EXPECT_GT(record.duration, 0);
+        EXPECT_GT(record.value, 0.f);
+        EXPECT_GT(record.averageMel, 0.f);
+    }
+}
+
 TEST_F(SoundDoseManagerTest, InvalidHalInterfaceIsNotSet) {
     EXPECT_FALSE(mSoundDoseManager->setHalSoundDoseInterface(kPrimaryModule, nullptr));
 }
@@ -176,6 +176,9 @@ status_t AudioPolicyManager::setDeviceConnectionStateInt(audio_devices_t deviceT
 status_t AudioPolicyManager::setDeviceConnectionStateInt(const sp<DeviceDescriptor> &device,
                                                          audio_policy_dev_state_t state)
 {
+    // Device availability and encoded formats affect which outputs can serve the devices.
+    invalidateOutputSelectionCache();
+
     // handle output devices
     if (audio_is_output_device(device->type())) {
         SortedVector <audio_io_handle_t> outputs;
@@ -1411,10 +1414,16 @@ status_t AudioPolicyManager::getOutputForAttr(const audio_attributes_t *attr,
       requestedDevice != nullptr ? requestedPortId : AUDIO_PORT_HANDLE_NONE;
     *selectedDeviceId = sanitizedRequestedPortId;
 
+    const nsecs_t startNs = systemTime();
     status_t status = getOutputForAttrInt(&resultAttr, output, session, attr, stream, uid,
             config, flags, selectedDeviceId, &isRequestedDeviceForExclusiveUse,
             secondaryOutputs != nullptr ? &secondaryMixes : nullptr, outputType, isSpatialized,
             isBitPerfect);
+    const nsecs_t decisionNs = systemTime() - startNs;
+    mOutputSelectionCache.decisionCount++;
+    mOutputSelectionCache.totalDecisionNs += decisionNs;
+    mOutputSelectionCache.maxDecisionNs = std::max(mOutputSelectionCache.maxDecisionNs,
+                                                   decisionNs);
     if (status != NO_ERROR) {
         return status;
     }
@@ -1637,8 +1646,8 @@ audio_io_handle_t AudioPolicyManager::getOutputForDevices(
     if (audio_is_linear_pcm(config->format)) {
         // get which output is suitable for the specified stream. The actual
         // routing change will happen when startOutput() will be called
-        SortedVector<audio_io_handle_t> outputs = getOutputsForDevices(devices, mOutputs);
         if (prefMixerConfigInfo != nullptr) {
+            SortedVector<audio_io_handle_t> outputs = getOutputsForDevices(devices, mOutputs);
             for (audio_io_handle_t outputHandle : outputs) {
                 sp<SwAudioOutputDescriptor> outputDesc = mOutputs.valueFor(outputHandle);
                 if (outputDesc->mProfile == prefMixerConfigInfo->getProfile()) {
@@ -1665,8 +1674,8 @@ audio_io_handle_t AudioPolicyManager::getOutputForDevices(
             // at this stage we should ignore the DIRECT flag as no direct output could be
             // found earlier
             *flags = (audio_output_flags_t) (*flags & ~AUDIO_OUTPUT_FLAG_DIRECT);
-            output = selectOutput(
-                    outputs, *flags, config->format, channelMask, config->sample_rate, session);
+            output = selectOutputForDevices(
+                    devices, *flags, config->format, channelMask, config->sample_rate, session);
         }
     }
     ALOGW_IF((output == 0), "getOutputForDevices() could not find output for stream %d, "
@@ -1970,6 +1979,60 @@ bool AudioPolicyManager::msdHasPatchesToAllDevices(const AudioDeviceTypeAddrVect
     return false;
 }
 
+audio_io_handle_t AudioPolicyManager::selectOutputForDevices(const DeviceVector &devices,
+                                                             audio_output_flags_t flags,
+                                                             audio_format_t format,
+                                                             audio_channel_mask_t channelMask,
+                                                             uint32_t samplingRate,
+                                                             audio_session_t sessionId)
+{
+    // A haptic-generating effect on the session overrides the selection, see selectOutput().
+    if (sessionId != AUDIO_SESSION_NONE &&
+            mEffects.getIoForSession(sessionId, FX_IID_HAPTICGENERATOR) != AUDIO_IO_HANDLE_NONE) {
+        return selectOutput(getOutputsForDevices(devices, mOutputs),
+                            flags, format, channelMask, samplingRate, sessionId);
+    }
+    std::vector<audio_port_handle_t> deviceIds;
+    deviceIds.reserve(devices.size());
+    for (const auto &device : devices) {
+        deviceIds.push_back(device->getId());
+    }
+    std::sort(deviceIds.begin(), deviceIds.end());
+    OutputSelectionCache::Key key{
+            std::move(deviceIds), flags, format, channelMask, samplingRate};
+    auto &decisions = mOutputSelectionCache.decisions;
+    if (auto it = decisions.find(key); it != decisions.end()) {
+        mOutputSelectionCache.hits++;
+        return it->second;
+    }
+    mOutputSelectionCache.misses++;
+    const audio_io_handle_t output = selectOutput(getOutputsForDevices(devices, mOutputs),
+            flags, format, channelMask, samplingRate, sessionId);
+    decisions.emplace(std::move(key), output);
+    return output;
+}
+
+void AudioPolicyManager::invalidateOutputSelectionCache()
+{
+    if (!mOutputSelectionCache.decisions.empty()) {
+        mOutputSelectionCache.decisions.clear();
+        mOutputSelectionCache.invalidations++;
+    }
+}
+
+void AudioPolicyManager::OutputSelectionCache::dump(String8 *dst) const
+{
+    const uint64_t lookups = hits + misses;
+    dst->appendFormat(" Output selection cache: %zu entries, %" PRIu64 " hits / %" PRIu64
+            " lookups (%.1f%%), %" PRIu64 " invalidations\n",
+            decisions.size(), hits, lookups, lookups == 0 ? 0. : 100. * hits / lookups,
+            invalidations);
+    dst->appendFormat(" getOutputForAttr latency: %" PRIu64 " calls, average %.1f us,"
+            " max %.1f us\n", decisionCount,
+            decisionCount == 0 ? 0. : totalDecisionNs / 1000. / decisionCount,
+            maxDecisionNs / 1000.);
+}
+
 audio_io_handle_t AudioPolicyManager::selectOutput(const SortedVector<audio_io_handle_t>& outputs,
                                                    audio_output_flags_t flags,
                                                    audio_format_t format,
@@ -4241,6 +4304,7 @@ void AudioPolicyManager::dump(String8 *dst) const
     mAudioPatches.dump(dst);
     mPolicyMixes.dump(dst);
     mAudioSources.dump(dst);
+    mOutputSelectionCache.dump(dst);
 
     dst->appendFormat(" AllowedCapturePolicies:\n");
     for (auto& policy : mAllowedCapturePolicies) {
@@ -6379,6 +6443,7 @@ void AudioPolicyManager::addOutput(audio_io_handle_t output,
                                    const sp<SwAudioOutputDescriptor>& outputDesc)
 {
     mOutputs.add(output, outputDesc);
+    invalidateOutputSelectionCache();
     applyStreamVolumes(outputDesc, DeviceTypeSet(), 0 /* delayMs */, true /* force */);
     updateMono(output); // update mono status when adding to output list
     selectOutputForMusicEffects();
@@ -6392,6 +6457,7 @@ void AudioPolicyManager::removeOutput(audio_io_handle_t output)
         mPrimaryOutput = nullptr;
     }
     mOutputs.removeItem(output);
+    invalidateOutputSelectionCache();
     selectOutputForMusicEffects();
 }
 
@@ -6882,6 +6948,25 @@ void AudioPolicyManager::clearAudioSourcesForOutput(audio_io_handle_t output)
 }
 
 void AudioPolicyManager::checkOutputForAttributes(const audio_attributes_t &attr)
+{
+    const auto psId = mEngine->getProductStrategyForAttributes(attr);
+    StrategyClients strategyClients;
+    for (size_t i = 0; i < mPreviousOutputs.size(); i++) {
+        const sp<SwAudioOutputDescriptor>& desc = mPreviousOutputs.valueAt(i);
+        if (desc->isDuplicated()) {
+            continue;
+        }
+        for (const sp<TrackClientDescriptor>& client : desc->getClientIterable()) {
+            if (mEngine->getProductStrategyForAttributes(client->attributes()) == psId) {
+                strategyClients.emplace_back(desc, client);
+            }
+        }
+    }
+    checkOutputForAttributes(attr, strategyClients);
+}
+
+void AudioPolicyManager::checkOutputForAttributes(const audio_attributes_t &attr,
+                                                  const StrategyClients &strategyClients)
 {
     auto psId = mEngine->getProductStrategyForAttributes(attr);
 
@@ -6896,29 +6981,20 @@ void AudioPolicyManager::checkOutputForAttributes(const audio_attributes_t &attr
     std::vector<sp<SwAudioOutputDescriptor>> invalidatedOutputs;
     // take into account dynamic audio policies related changes: if a client is now associated
     // to a different policy mix than at creation time, invalidate corresponding stream
-    for (size_t i = 0; i < mPreviousOutputs.size(); i++) {
-        const sp<SwAudioOutputDescriptor>& desc = mPreviousOutputs.valueAt(i);
-        if (desc->isDuplicated()) {
+    for (const auto& [desc, client] : strategyClients) {
+        sp<AudioPolicyMix> primaryMix;
+        status_t status = mPolicyMixes.getOutputForAttr(client->attributes(), client->config(),
+                client->uid(), client->session(), client->flags(), mAvailableOutputDevices,
+                nullptr /* requestedDevice */, primaryMix, nullptr /* secondaryMixes */,
+                unneededUsePrimaryOutputFromPolicyMixes);
+        if (status != OK) {
             continue;
         }
-        for (const sp<TrackClientDescriptor>& client : desc->getClientIterable()) {
-            if (mEngine->getProductStrategyForAttributes(client->attributes()) != psId) {
-                continue;
-            }
-            sp<AudioPolicyMix> primaryMix;
-            status_t status = mPolicyMixes.getOutputForAttr(client->attributes(), client->config(),
-                    client->uid(), client->session(), client->flags(), mAvailableOutputDevices,
-                    nullptr /* requestedDevice */, primaryMix, nullptr /* secondaryMixes */,
-                    unneededUsePrimaryOutputFromPolicyMixes);
-            if (status != OK) {
-                continue;
-            }
-            if (client->getPrimaryMix() != primaryMix || client->hasLostPrimaryMix()) {
-                if (desc->isStrategyActive(psId) && maxLatency < desc->latency()) {
-                    maxLatency = desc->latency();
-                }
-                invalidatedOutputs.push_back(desc);
+        if (client->getPrimaryMix() != primaryMix || client->hasLostPrimaryMix()) {
+            if (desc->isStrategyActive(psId) && maxLatency < desc->latency()) {
+                maxLatency = desc->latency();
             }
+            invalidatedOutputs.push_back(desc);
         }
     }
 
@@ -6997,9 +7073,24 @@ void AudioPolicyManager::checkOutputForAttributes(const audio_attributes_t &attr
 
 void AudioPolicyManager::checkOutputForAllStrategies()
 {
+    // Resolve the strategy of each client once instead of once per strategy.
+    std::map<product_strategy_t, StrategyClients> clientsByStrategy;
+    for (size_t i = 0; i < mPreviousOutputs.size(); i++) {
+        const sp<SwAudioOutputDescriptor>& desc = mPreviousOutputs.valueAt(i);
+        if (desc->isDuplicated()) {
+            continue;
+        }
+        for (const sp<TrackClientDescriptor>& client : desc->getClientIterable()) {
+            clientsByStrategy[mEngine->getProductStrategyForAttributes(client->attributes())]
+                    .emplace_back(desc, client);
+        }
+    }
+    static const StrategyClients kNoClients;
     for (const auto &strategy : mEngine->getOrderedProductStrategies()) {
         auto attributes = mEngine->getAllAttributesForProductStrategy(strategy).front();
-        checkOutputForAttributes(attributes);
+        auto it = clientsByStrategy.find(mEngine->getProductStrategyForAttributes(attributes));
+        checkOutputForAttributes(attributes,
+                it != clientsByStrategy.end() ? it->second : kNoClients);
         checkAudioSourceForAttributes(attributes);
     }
 }
@@ -7348,6 +7439,7 @@ uint32_t AudioPolicyManager::setBeaconMute(bool mute) {
 
 void AudioPolicyManager::updateDevicesAndOutputs()
 {
+    invalidateOutputSelectionCache();
     mEngine->updateDeviceSelectionCache();
     mPreviousOutputs = mOutputs;
 }
@@ -18,8 +18,11 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
+#include <tuple>
 #include <unordered_set>
+#include <vector>
 
 #include <stdint.h>
 #include <sys/types.h>
@@ -696,6 +699,17 @@ protected:
          */
         void checkOutputForAttributes(const audio_attributes_t &attr);
 
+        // Clients of non duplicated outputs in mPreviousOutputs following a product strategy.
+        using StrategyClients = std::vector<std::pair<sp<SwAudioOutputDescriptor>,
+                                                      sp<TrackClientDescriptor>>>;
+        /**
+         * @brief same as @see checkOutputForAttributes(const audio_attributes_t &attr)
+         *      with the clients following the strategy of attr already collected, so that
+         *      the policy mix checks only visit the clients that the strategy can affect.
+         */
+        void checkOutputForAttributes(const audio_attributes_t &attr,
+                                      const StrategyClients &strategyClients);
+
         /**
          * @brief checkAudioSourceForAttributes checks if any AudioSource following the same routing
          * as the given audio attributes is not routed and try to connect it.
@@ -711,7 +725,10 @@ protected:
 
         /**
          * @brief checkOutputForAllStrategies Same as @see checkOutputForAttributes()
-         *      but for a all product strategies in order of priority
+         *      but for a all product strategies in order of priority.
+         *      The clients of the previous outputs are grouped by strategy in a single pass,
+         *      so the cost is proportional to the number of clients plus the number of
+         *      strategies rather than their product.
          */
         void checkOutputForAllStrategies();
 
@@ -775,6 +792,20 @@ protected:
                                        audio_channel_mask_t channelMask = AUDIO_CHANNEL_NONE,
                                        uint32_t samplingRate = 0,
                                        audio_session_t sessionId = AUDIO_SESSION_NONE);
+        /**
+         * @brief selectOutputForDevices: same as selectOutput(getOutputsForDevices(devices,
+         *      mOutputs), ...) but memoized in mOutputSelectionCache.
+         *      The decision only depends on the devices, the request and the opened outputs,
+         *      so the cache is cleared whenever outputs are opened or closed or device
+         *      capabilities or routing change (see invalidateOutputSelectionCache()).
+         */
+        audio_io_handle_t selectOutputForDevices(const DeviceVector &devices,
+                                                 audio_output_flags_t flags,
+                                                 audio_format_t format,
+                                                 audio_channel_mask_t channelMask,
+                                                 uint32_t samplingRate,
+                                                 audio_session_t sessionId);
+        void invalidateOutputSelectionCache();
         // samplingRate, format, channelMask are in/out and so may be modified
         sp<IOProfile> getInputProfile(const sp<DeviceDescriptor> & device,
                                       uint32_t& samplingRate,
@@ -985,6 +1016,24 @@ protected:
         AudioPolicyMixCollection mPolicyMixes; // list of registered mixes
         audio_io_handle_t mMusicEffectOutput;     // output selected for music effects
 
+        // Memoized mixed output selection, see selectOutputForDevices().
+        struct OutputSelectionCache {
+            using Key = std::tuple<std::vector<audio_port_handle_t> /* device ids */,
+                                   audio_output_flags_t, audio_format_t,
+                                   audio_channel_mask_t, uint32_t /* samplingRate */>;
+            std::map<Key, audio_io_handle_t> decisions;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t invalidations = 0;
+            // getOutputForAttr() latency
+            uint64_t decisionCount = 0;
+            nsecs_t totalDecisionNs = 0;
+            nsecs_t maxDecisionNs = 0;
+
+            void dump(String8 *dst) const;
+        };
+        OutputSelectionCache mOutputSelectionCache;
+
         uint32_t nextAudioPortGeneration();
 
         // Surround formats that are enabled manually. Taken into account when
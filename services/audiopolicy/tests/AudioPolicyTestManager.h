@@ -43,6 +43,8 @@ class AudioPolicyTestManager : public AudioPolicyManager {
     using AudioPolicyManager::deviceToAudioPort;
     using AudioPolicyManager::handleDeviceConfigChange;
     uint32_t getAudioPortGeneration() const { return mAudioPortGeneration; }
+    uint64_t getOutputSelectionCacheHits() const { return mOutputSelectionCache.hits; }
+    uint64_t getOutputSelectionCacheMisses() const { return mOutputSelectionCache.misses; }
 };
 
 }  // namespace android
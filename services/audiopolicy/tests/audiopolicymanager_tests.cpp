@@ -384,6 +384,23 @@ TEST_F(AudioPolicyManagerTest, Dump) {
     dumpToLog();
 }
 
+TEST_F(AudioPolicyManagerTest, OutputSelectionIsCached) {
+    audio_port_handle_t selectedDeviceId = AUDIO_PORT_HANDLE_NONE;
+    audio_io_handle_t output1 = AUDIO_IO_HANDLE_NONE;
+    ASSERT_NO_FATAL_FAILURE(getOutputForAttr(&selectedDeviceId, AUDIO_FORMAT_PCM_16_BIT,
+            AUDIO_CHANNEL_OUT_STEREO, k48000SamplingRate, AUDIO_OUTPUT_FLAG_NONE, &output1));
+    const uint64_t hits = mManager->getOutputSelectionCacheHits();
+    const uint64_t misses = mManager->getOutputSelectionCacheMisses();
+
+    selectedDeviceId = AUDIO_PORT_HANDLE_NONE;
+    audio_io_handle_t output2 = AUDIO_IO_HANDLE_NONE;
+    ASSERT_NO_FATAL_FAILURE(getOutputForAttr(&selectedDeviceId, AUDIO_FORMAT_PCM_16_BIT,
+            AUDIO_CHANNEL_OUT_STEREO, k48000SamplingRate, AUDIO_OUTPUT_FLAG_NONE, &output2));
+    EXPECT_EQ(output1, output2);
+    EXPECT_EQ(hits + 1, mManager->getOutputSelectionCacheHits());
+    EXPECT_EQ(misses, mManager->getOutputSelectionCacheMisses());
+}
+
 TEST_F(AudioPolicyManagerTest, CreateAudioPatchFailure) {
     audio_patch patch{};
     audio_patch_handle_t handle = AUDIO_PATCH_HANDLE_NONE;
@@ -42,7 +42,7 @@ void AAudioMixer::allocate(int32_t samplesPerFrame, int32_t framesPerBurst) {
 }
 
 void AAudioMixer::clear() {
-    memset(mOutputBuffer.get(), 0, mBufferSizeInBytes);
+    mStreamsMixed = 0;
 }
 
 int32_t AAudioMixer::mix(
@@ -88,7 +88,7 @@ int32_t AAudioMixer::mix(
             if (framesToMixFromPart > framesAvailableFromPart) {
                 framesToMixFromPart = framesAvailableFromPart;
             }
-            mixPart(destination, (float *)wrappingBuffer.data[partIndex],
+            mixPart(destination, (const float *)wrappingBuffer.data[partIndex],
                     framesToMixFromPart);
 
             destination += framesToMixFromPart * mSamplesPerFrame;
@@ -96,6 +96,12 @@ int32_t AAudioMixer::mix(
         }
         partIndex++;
     }
+    // The first stream was copied, so silence the rest of the burst.
+    if (mStreamsMixed == 0) {
+        const int32_t framesMixed = framesDesired - framesLeft;
+        memset(destination, 0, (mFramesPerBurst - framesMixed) * mSamplesPerFrame * sizeof(float));
+    }
+    mStreamsMixed++;
     fifo->advanceReadIndex(framesDesired);
 
 #if AAUDIO_MIXER_ATRACE_ENABLED
@@ -105,14 +111,24 @@ int32_t AAudioMixer::mix(
     return (framesDesired - framesLeft); // framesRead
 }
 
-void AAudioMixer::mixPart(float *destination, float *source, int32_t numFrames) {
+void AAudioMixer::mixPart(float *destination, const float *source, int32_t numFrames) {
     int32_t numSamples = numFrames * mSamplesPerFrame;
-    // TODO maybe optimize using SIMD
+    if (mStreamsMixed == 0) {
+        memcpy(destination, source, numSamples * sizeof(float));
+        return;
+    }
+    // The client FIFO never overlaps the mixer buffer. Telling the compiler so lets it
+    // vectorize the loop without runtime alias checks.
+    float * __restrict dst = destination;
+    const float * __restrict src = source;
     for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++) {
-        *destination++ += *source++;
+        dst[sampleIndex] += src[sampleIndex];
     }
 }
 
 float *AAudioMixer::getOutputBuffer() {
+    if (mStreamsMixed == 0) {
+        memset(mOutputBuffer.get(), 0, mBufferSizeInBytes);
+    }
     return mOutputBuffer.get();
 }
@@ -28,6 +28,11 @@ public:
 
     void allocate(int32_t samplesPerFrame, int32_t framesPerBurst);
 
+    /**
+     * Start a new burst. The output buffer is not cleared here.
+     * The first stream mixed is copied and only the later ones are accumulated,
+     * which saves a pass over the buffer.
+     */
     void clear();
 
     /**
@@ -41,14 +46,18 @@ public:
                 const std::shared_ptr<android::FifoBuffer>& fifo,
                 bool allowUnderflow);
 
+    /**
+     * @return the mixed burst, silence if no stream was mixed since clear()
+     */
     float *getOutputBuffer();
 
     int32_t getFramesPerBurst() const { return mFramesPerBurst; }
 
 private:
-    void mixPart(float *destination, float *source, int32_t numFrames);
+    void mixPart(float *destination, const float *source, int32_t numFrames);
 
     std::unique_ptr<float[]> mOutputBuffer;
+    int32_t  mStreamsMixed = 0; // since clear()
     int32_t  mSamplesPerFrame = 0;
     int32_t  mFramesPerBurst = 0;
     int32_t  mBufferSizeInBytes = 0;